@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+
+// Define a bitboard as a 64 bit mask holding one bit per tile
+// Bit index is x + 8 * y; Bit 0 is the top left tile (0, 0)
+typedef std::uint64_t bitboard;
+
+// Types of pieces used to index bitboards
+enum PieceType { Pawn, Rook, Knight, Bishop, Queen, King };
+
+// Stages of the game the evaluation blends between, used to index midgame and endgame scores
+enum GamePhase { Midgame, Endgame };
+
+// Masks for the outer columns of the board
+const bitboard leftColumn = 0x0101010101010101ULL;
+const bitboard rightColumn = leftColumn << 7;
+
+// Returns a mask of a full row of the board
+inline bitboard rowMask(const int y)
+{ return 0xFFULL << (8 * y); }
+
+// Converts a pair of coordinates to a tile index
+inline int squareIndex(const int x, const int y)
+{ return x + 8 * y; }
+
+// Returns a bitboard holding a single tile
+inline bitboard squareMask(const int square)
+{ return 1ULL << square; }
+
+// Returns the number of tiles set on a bitboard
+inline int popCount(const bitboard board)
+{ return __builtin_popcountll(board); }
+
+// Returns the index of the lowest tile set on a non-empty bitboard
+inline int lowestSquare(const bitboard board)
+{ return __builtin_ctzll(board); }
+
+// Removes the lowest tile from a non-empty bitboard and returns its index
+inline int popLowestSquare(bitboard& board)
+{
+	int square = __builtin_ctzll(board);
+	board &= board - 1;
+	return square;
+}
+
+// Shift every tile of a bitboard one step in a direction, dropping tiles that leave the board
+// Up -> towards row 0 | Down -> towards row 7
+inline bitboard shiftUp(const bitboard board)
+{ return board >> 8; }
+
+inline bitboard shiftDown(const bitboard board)
+{ return board << 8; }
+
+inline bitboard shiftLeft(const bitboard board)
+{ return (board >> 1) & ~rightColumn; }
+
+inline bitboard shiftRight(const bitboard board)
+{ return (board << 1) & ~leftColumn; }
+
+// Precomputed attacks of the pieces that do not slide
+extern bitboard pawnTable[2][64], knightTable[64], kingTable[64];
+
+// Returns the tiles a pawn attacks from a given square
+// Side 0 -> White (attacks up) | Side 1 -> Black (attacks down)
+inline bitboard pawnAttacks(const int side, const int square)
+{ return pawnTable[side][square]; }
+
+// Returns the tiles a knight attacks from a given square
+inline bitboard knightAttacks(const int square)
+{ return knightTable[square]; }
+
+// Returns the tiles a king attacks from a given square
+inline bitboard kingAttacks(const int square)
+{ return kingTable[square]; }
+
+// Magic bitboard lookup for the attacks of a sliding piece on one tile
+// Multiplying the relevant occupancy by a magic number packs it into a unique table index
+struct Magic
+{
+	// Tiles whose occupancy changes the attacks (Board edges excluded)
+	bitboard mask;
+
+	// Multiplier found at start up that maps each occupancy to its own index
+	bitboard number;
+
+	// Attack table of this tile, indexed by the magic index
+	const bitboard* attacks;
+
+	// Shift that keeps only the index bits of the product
+	unsigned int shift;
+
+	// Returns the attacks for a given board occupancy
+	bitboard Attacks(const bitboard occupied) const
+	{ return attacks[((occupied & mask) * number) >> shift]; }
+};
+
+// Magic lookups for rooks and bishops on each tile
+extern Magic rookMagics[64], bishopMagics[64];
+
+// Returns the tiles a rook attacks from a given square; Rays stop on the first occupied tile
+inline bitboard rookAttacks(const int square, const bitboard occupied)
+{ return rookMagics[square].Attacks(occupied); }
+
+// Returns the tiles a bishop attacks from a given square; Rays stop on the first occupied tile
+inline bitboard bishopAttacks(const int square, const bitboard occupied)
+{ return bishopMagics[square].Attacks(occupied); }
+
+// Returns the tiles a queen attacks from a given square; Rays stop on the first occupied tile
+inline bitboard queenAttacks(const int square, const bitboard occupied)
+{ return rookAttacks(square, occupied) | bishopAttacks(square, occupied); }
+
+// Tiles strictly between two tiles that share a row, column or diagonal, and the full line through them
+extern bitboard betweenTable[64][64], lineTable[64][64];
+
+// Returns the tiles strictly between two tiles; Empty if the tiles are not aligned
+inline bitboard betweenSquares(const int from, const int to)
+{ return betweenTable[from][to]; }
+
+// Returns every tile on the line through two tiles, edge to edge; Empty if the tiles are not aligned
+inline bitboard lineThrough(const int from, const int to)
+{ return lineTable[from][to]; }
\ No newline at end of file
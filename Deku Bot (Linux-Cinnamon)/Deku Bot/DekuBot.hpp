@@ -1,20 +1,49 @@
 #pragma once
 
+#include "EvalCache.hpp"
 #include "GameBoard.hpp"
+#include "PawnTable.hpp"
+#include "SplitPoint.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <vector>
+
+// Ways the threads of a search share the work
+// Lazy SMP -> Every thread searches the whole tree, sharing only the table | Split Points -> Idle threads help search the brothers of moves already searched
+enum ParallelSearch { LazySMP, SplitPoints };
 
 // Deku Chess Bot
 class DekuBot
 {
 public:
-	// Explicit Constructor takes a reference to an existing game board and the AI's color (1 -> White | -1 -> Black)
-	DekuBot(GameBoard *board, const int color);
+	// Explicit Constructor takes a reference to an existing game board, the AI's color (1 -> White | -1 -> Black),
+	// the size of the transposition table in megabytes and the number of threads that search together
+	DekuBot(GameBoard *board, const int color, const int hashMegabytes = 32, const int threads = 1);
+
+	// Sets the number of threads that search together; Helper threads share the transposition table
+	void SetThreads(const int threads);
+
+	// Limits how deep each search may go; Zero searches until time runs out
+	void SetDepthLimit(const int depth);
+
+	// Sets how the threads of a search share the work
+	void SetParallelSearch(const ParallelSearch mode);
 
 	// Makes a move on the chess board
 	// Takes the maximum ammount of time in minutes the AI is allowed to search
 	void MakeMove(int maxTime);
 
-private:
+	// Checks if the AI found itself without a legal move, ending the game
+	bool IsGameOver() const
+	{ return gameOver; }
+
+	// Asks a running search to stop as soon as possible
+	// Safe to call from another thread, such as the GUI
+	void Stop();
+
+protected:
 	// ----- Data Members ----- \\
 
 	// Reference to a game board
@@ -27,13 +56,209 @@ private:
 	// Maximum ammount of time specified by the user for each move in milliseconds
 	int maxSearchTime;
 
+	// Set once the AI has no legal move left; No move is made or announced after
+	bool gameOver;
+
+	// Table owned by the main thread; Empty on helpers
+	std::unique_ptr<TranspositionTable> ownedTable;
+
+	// Positions searched so far; Kept between moves since the game often reaches them again
+	// Shared by every thread of the search
+	TranspositionTable &table;
+
+	// Pawn structures scored so far; Each thread keeps its own, so it is never shared
+	PawnTable pawnTable;
+
+	// Static evaluations of positions met so far; Each thread keeps its own, so it is never shared
+	EvalCache evalCache;
+
+	// Deepest ply that keeps killer moves
+	static const int maxPly = 128;
+	static_assert(maxPly <= SplitPoint::maxPly, "Split points must hold every line the search can reach");
+
+	// Two quiet moves per ply that recently cut the search short
+	Move killers[maxPly][2];
+
+	// How often each quiet move cut the search short, by side, initial tile and final tile
+	int history[2][64][64];
+
+	// Number of cutoffs in the last search, and how many of them came from the first move tried
+	long long cutoffs, firstMoveCutoffs;
+
+	// Whether quiescence searches every escape from check instead of standing pat while in check
+	bool quiescenceEvasions;
+
+	// Whether late quiet moves are searched shallower first
+	bool lateMoveReductions;
+
+	// Flag owned by the main thread; Unused on helpers
+	std::atomic<bool> ownedStopFlag;
+
+	// Set when the search has to stop, either by the clock or by a call to Stop
+	// Shared by every thread of the search
+	std::atomic<bool> &stopFlag;
+
+	// Time the current search has to stop by
+	std::chrono::steady_clock::time_point deadline;
+
+	// Nodes searched so far in the current search
+	long long nodes;
+
+	// Number of nodes between readings of the clock; A power of two
+	static const int pollInterval = 4096;
+
+	// Half the width of the first aspiration window around the last depth's score
+	int aspirationWindow;
+
+	// Score of the move chosen by the last search
+	int searchScore;
+
+	// Triangular table of principal variations; Row N holds the best line found from ply N, starting at column N
+	Move pvTable[maxPly][maxPly];
+
+	// End of the line held in each row of the table
+	int pvLength[maxPly];
+
+	// Whether the move made at each ply was a null move
+	bool nullMoveMade[maxPly];
+
+	// Key of the position reached at each ply of the line being searched
+	std::uint64_t positionKeys[maxPly];
+
+	// Keys of the positions played in the game, ending with the root of the search
+	// Only those since the last capture or pawn move are kept, since no older one can come back; Only kept by the main thread
+	std::vector<std::uint64_t> gameKeys;
+
+	// Moves without a capture or pawn move after which the game is drawn
+	static const int fiftyMoveLimit = 100;
+
+	// Deepest depth a search may finish; Zero for no limit
+	int depthLimit;
+
+	// Index of the thread this bot searches on; Zero for the main thread, which alone decides the move
+	int threadIndex;
+
+	// Bots searching the same root on their own threads; Each keeps its own board, killers and history
+	// Only the main thread holds helpers
+	std::vector<std::unique_ptr<DekuBot>> helpers;
+
+	// Bot of the main thread; Itself on the main thread
+	DekuBot *master;
+
+	// How the threads of a search share the work
+	ParallelSearch parallelMode;
+
+	// Helper threads waiting for a split point to join; Only kept by the main thread
+	std::atomic<int> idleWorkers;
+
+	// Split points this thread owns, offered to the other threads
+	SplitDeque splits;
+
+	// Innermost split point this thread is searching moves of; Null outside of any
+	const SplitPoint *activeSplit;
+
+	// Least depth left at which a node is worth sharing between threads
+	static const int minSplitDepth = 4;
+
 	// ----- Methods ----- \\
 
+	// Helper Constructor; Shares the board, table and stop flag of the main bot
+	DekuBot(DekuBot &master, const int index);
+
 	// Search the tree Breadth First
+	// The caller clears the stop flag beforehand, so a Stop that comes while the search starts up still counts
 	// Returns the best move after a given amount of time
-	std::pair<coordinates, coordinates> breadthFirstSearch(std::vector<std::pair<coordinates, coordinates>> &moves);
+	Move breadthFirstSearch(MoveList &moves);
+
+	// Searches every root move to a given depth within a window; The first move gets the full window, the rest a null window
+	// Fills the best move found, along with the score and subtree size of each move
+	// Returns the best score found
+	int rootSearch(GameBoard &board, MoveList &moves, int alpha, int beta, const int depth, Move &depthMove, int rootScores[], long long rootNodes[]);
 
 	// Recursively find the best possible outcome for a move
+	// Takes the depth left to search and the number of moves made since the root
+	// Returns an integer
+	int miniMaxMove(GameBoard &nextGame, int alpha, int beta, int currentDepth, int ply);
+
+	// Makes a move and searches it with the window of its node, then takes it back
+	// Takes the index and ordering score of the move, which decide how much its depth may be reduced
+	// Returns the score of the move
+	int searchMove(GameBoard &nextGame, const Move move, const int index, const int score, int alpha, int beta, const int currentDepth, const int ply, const bool aiTurn, const bool inCheck);
+
+	// Young Brothers Wait; Shares the moves of a node left after its eldest brother between this thread and idle threads
+	// Updates the window, best score, best move and line of the node with everything found
+	void SplitNode(GameBoard &nextGame, MoveList &moves, int scores[], const int index, int &alpha, int &beta, int &bestValue, Move &bestMove, const int currentDepth, const int ply, const bool aiTurn, const bool inCheck);
+
+	// Searches moves of a split point until none are left or the node is cut off
+	void SearchSplitPoint(GameBoard &board, SplitPoint &split);
+
+	// Searches a split point this thread has joined on a copy of its board, then leaves it
+	void JoinSplitPoint(SplitPoint &split);
+
+	// Loop of a helper thread while splitting nodes; Joins split points of other threads until the search stops
+	void WaitForWork();
+
+	// Joins a split point of another thread; Only one below an ancestor if one is given
+	// Returns the split point, or null if none had work left
+	SplitPoint* StealWork(const SplitPoint *ancestor);
+
+	// Checks if the current node may be shared between threads
+	bool CanSplit(const int currentDepth) const;
+
+	// Checks if a node may pass the turn to prove its score is past the window
+	// Never while in check, right after another null move, inside the principal variation, or with only pawns left,
+	// where passing could be the best move and the test would lie
+	bool CanNullMove(const GameBoard &game, const int alpha, const int beta, const int currentDepth, const int ply, const int staticFitness) const;
+
+	// Forgets the killer moves of the last position and halves the history
+	void AgeMoveOrdering();
+
+	// Checks if a position is drawn by the fifty move rule or by repetition
+	// A position met earlier on the line searched repeats once, while one from before the root must have been played twice
+	bool IsDraw(const GameBoard &game, const int ply) const;
+
+	// Checks if the search has to stop, or a split point this thread works under was cut off
+	// Either way the result of the current node is thrown away
+	bool Aborted() const;
+
+	// Ranks a board for the AI, reusing the score of an earlier visit to the same position
+	// Returns an integer representing it's fitness
+	int StaticEvaluation(const GameBoard &game);
+
+	// Searches only captures and promotions until the position is quiet, so a leaf is never judged mid exchange
 	// Returns an integer
-	int miniMaxMove(GameBoard &nextGame, int alpha, int beta, int currentDepth, std::chrono::_V2::system_clock::time_point startTime);
+	int quiescenceSearch(GameBoard &nextGame, int alpha, int beta, int ply);
+
+	// Stores the result of searching a position in the transposition table
+	// Results cut short by the search time are not trusted and are left out
+	void StoreResult(const GameBoard &game, const Move bestMove, const int score, const int depth, const int alpha, const int beta);
+
+	// Counts a searched node, reading the clock only once every few thousand nodes
+	// Returns true once the search should stop
+	bool ShouldStop();
+
+	// Scores every move of a list for move ordering
+	// Hash move -> Captures and promotions by most valuable victim, then least valuable attacker -> Killer moves -> Quiet moves by history
+	void ScoreMoves(const GameBoard &game, const MoveList &moves, int scores[], const Move hashMove, const int ply) const;
+
+	// Moves the best scored move not yet searched to a given index of the list
+	// Returns that move
+	static Move PickMove(MoveList &moves, int scores[], const int index);
+
+	// Remembers a move that cut the search short so it is tried early in similar positions
+	// Quiet moves become killers for their ply and gain history; Captures are already ordered well
+	void RecordCutoff(const GameBoard &game, const Move move, const int index, const int depth, const int ply);
+
+	// Puts a move in front of the line its child found, making it the line of a given ply
+	void UpdatePrincipalVariation(const int ply, const Move move);
+
+	// Prints the depth, score, nodes, time and principal variation of a finished depth
+	void PrintPrincipalVariation(const int depth, const int score) const;
+
+	// Sorts the root moves for the next depth; The last best move first, then by score, then by subtree size
+	// Scores and node counts are sorted along with their moves
+	static void OrderRootMoves(MoveList &moves, int scores[], long long nodeCounts[], const Move bestMove);
+
+	// Checks if one root move should be searched before another
+	static bool RootMoveBefore(const Move move, const int score, const long long count, const Move other, const int otherScore, const long long otherCount, const Move bestMove);
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// Hash table of static evaluations, indexed by Zobrist keys
+// Each search thread owns one, so entries are read and written without locks
+// A new score simply replaces the old one in its slot; Iterative deepening visits the same positions again and again
+class EvalCache
+{
+public:
+	// Default Constructor; Every slot starts out empty
+	EvalCache();
+
+	// Looks up the score of a position by its key
+	// Returns true and fills the score if the position was found
+	bool Probe(const std::uint64_t key, int& score) const
+	{
+		const Entry& entry = entries[key & (size - 1)];
+		if (entry.key != key)
+			return false;
+
+		score = entry.score;
+		return true;
+	}
+
+	// Stores the score of a position, replacing whatever shared its slot
+	void Store(const std::uint64_t key, const int score)
+	{
+		Entry& entry = entries[key & (size - 1)];
+		entry.key = key;
+		entry.score = score;
+	}
+
+private:
+	// ----- Data Members ----- \\
+
+	// Score of one position and the key it belongs to; A key of zero marks an empty slot
+	struct Entry
+	{
+		std::uint64_t key;
+		int score;
+	};
+
+	// Number of entries; A power of two so a key masks straight to its slot
+	static const int size = 1 << 15;
+
+	std::unique_ptr<Entry[]> entries;
+};
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
+#include "Move.hpp"
+#include "PawnTable.hpp"
 #include <map>
-#include <vector>
+#include <string>
 
 // Define a piece as an 8 bit integer
 typedef char piece;
@@ -10,6 +11,35 @@ typedef char piece;
 // Define a coordinate as a pair of positive integers
 typedef std::pair<unsigned int, unsigned int> coordinates;
 
+// Castling rights stored as bits of a mask
+enum CastlingRight { WhiteShort = 1, WhiteLong = 2, BlackShort = 4, BlackLong = 8 };
+
+// Holds everything DoMove changes that can not be recomputed from the move itself
+// Filled by GameBoard::DoMove and handed back to GameBoard::UndoMove
+struct UndoRecord
+{
+	// Moves since a capture or pawn move before the move
+	int movesSinceCapture;
+
+	// En passant tile before the move; -1 if there was none
+	std::int8_t enPassantSquare;
+
+	// Castling rights before the move
+	std::uint8_t castlingRights;
+
+	// Value of the moving piece before the move
+	piece moved;
+
+	// Value of the captured piece; 0 if nothing was taken
+	piece captured;
+
+	// Check flags before the move
+	bool blackInCheck, whiteInCheck;
+
+	// Position key before the move
+	std::uint64_t positionKey;
+};
+
 // Holds information about the current game state
 // Inherit from sf::Drawable to allow drawing to screen
 class GameBoard
@@ -22,6 +52,10 @@ public:
 	// Takes a reference to a pre-made game board
 	GameBoard(const piece(&gameState)[8][8]);
 
+	// FEN Constructor
+	// Takes a position in Forsyth-Edwards Notation; Missing fields keep the values of a new game
+	explicit GameBoard(const std::string& fen);
+
 	// Copy Constructor
 	GameBoard(const GameBoard& rhs);
 
@@ -30,15 +64,40 @@ public:
 	// Returns true if move was made, false otherwise
 	bool MovePiece(const coordinates initial, const coordinates final);
 
+	// Makes a move generated by FindMoves for the player whose turn it is, without checking it
+	// Only for moves the engine generated itself; Input from the board goes through MovePiece
+	void ApplyMove(const Move move);
+
+	// Makes a move generated by FindMoves for the player whose turn it is, without checking it
+	// Fills an undo record that UndoMove uses to take the move back
+	void DoMove(const Move move, UndoRecord& undo);
+
+	// Takes back the last move made by DoMove
+	// Takes the same move and the undo record DoMove filled
+	void UndoMove(const Move move, const UndoRecord& undo);
+
+	// Passes the turn to the other player without moving a piece, for null move pruning
+	// Only valid when the player to move is not in check; Fills an undo record for UndoNullMove
+	void DoNullMove(UndoRecord& undo);
+
+	// Takes back the last null move made by DoNullMove
+	void UndoNullMove(const UndoRecord& undo);
+
 	// Ranks the board for a given color
 	// 1 -> White | -1 -> Black
+	// Every term has a midgame and an endgame weight, blended by the game phase
+	// Takes a table of pawn structures to look the pawns up in; Without one they are scored from scratch
 	// Returns an integer representing it's fitness
-	int RankBoard(const int color) const;
+	int RankBoard(const int color, PawnTable *pawnTable = nullptr) const;
+
+	// Finds all legal moves for a given color (1 for white, -1 for black)
+	// Takes whether to find only captures and promotions, as the quiescence search wants
+	// Fills a list of moves in place
+	void FindMoves(int color, MoveList& possibleMoves, const bool loudOnly = false) const;
 
-	// Finds all possible moves for a given color (1 for white, -1 for black)
-	// Returns a vector of pairs of coordinates (pair<int, int>)
-	// pair.first -> initial position | pair.second -> final position
-	std::vector<std::pair<coordinates, coordinates>> FindMoves(int color) const;
+	// Checks if a move generated by FindMoves for the player whose turn it is would put the other king in check
+	// Answers without making the move
+	bool GivesCheck(const Move move) const;
 
 	// Checks if black is in check
 	bool isBlackInCheck() const
@@ -65,6 +124,28 @@ public:
 	int numWhitePieces() const
 	{ return whitePieces; }
 
+	// Checks if a given color (1 for white, -1 for black) has any piece besides pawns and its king
+	bool hasNonPawnPieces(const int color) const
+	{
+		const bitboard* pieces = pieceBoards[SideIndex(color)];
+		return (pieces[Rook] | pieces[Knight] | pieces[Bishop] | pieces[Queen]) != 0;
+	}
+
+	// Returns the Zobrist key of the position
+	// Equal positions with the same player to move, castling rights and en passant file share a key
+	std::uint64_t positionKey() const
+	{ return zobristKey; }
+
+	// Returns how much material is left, from 0 with only kings and pawns up to maxPhase in a new game
+	// Pieces promoted past the starting material do not raise it further
+	int gamePhase() const
+	{ return phase < maxPhase ? phase : maxPhase; }
+
+	// Returns the Zobrist key of the pawns alone
+	// Boards with the same pawns on the same tiles share a key, whatever else differs
+	std::uint64_t pawnKey() const
+	{ return pawnZobristKey; }
+
 	// ----- Data Members ----- \\
 
 	// A 2D Array of pieces representing a game board; Top left is (0, 0)
@@ -83,13 +164,96 @@ protected:
 	// Integers hold how many pieces each side has
 	int blackPieces, whitePieces;
 
-	// Holds a copy of the previous board position
-	piece previousPosition[8][8];
+	// Bitboards of each type of piece for each side
+	// Side 0 -> White | Side 1 -> Black
+	bitboard pieceBoards[2][6];
+
+	// Bitboards of all tiles occupied by each side
+	bitboard sideBoards[2];
+
+	// Bitboard of all occupied tiles
+	bitboard occupiedBoard;
+
+	// Tile each side's king stands on; -1 if the king is missing
+	int kingSquares[2];
+
+	// Mask of CastlingRight bits still available
+	int castlingRights;
+
+	// Tile a pawn may move to when taking en passant; -1 if there is none
+	int enPassantSquare;
+
+	// Zobrist key of the position; Updated along with every piece, turn, castling and en passant change
+	std::uint64_t zobristKey;
+
+	// Zobrist key of the pawns alone; Updated along with every pawn put on or taken off the board
+	std::uint64_t pawnZobristKey;
+
+	// White's part of the fitness that only depends on which pieces stand on which tiles, minus black's
+	// Kept for the midgame and for the endgame; Updated along with every piece put on or taken off the board
+	int pieceSquareScore[2];
+
+	// Material left on the board, weighted by piece type; Updated along with every piece put on or taken off the board
+	int phase;
+
+	// Phase of a new game; Knights and bishops weigh one, rooks two and queens four
+	static const int maxPhase = 24;
 
 	// ----- Private Methods ----- \\
 
-	// Evaluates the current board and updates pieces / flags
-	void EvaluateBoard();
+	// Rebuilds every bitboard and both king tiles from the game board array
+	void UpdateBitboards();
+
+	// Rewrites the values of kings and corner rooks so the game board shows the castling rights
+	void UpdateCastleValues();
+
+	// Returns the corner rooks that may still castle
+	bitboard CastleRooks() const;
+
+	// Puts a piece on an empty tile, updating the game board and bitboards
+	void AddPiece(const int square, const piece value);
+
+	// Takes the piece off a tile, updating the game board and bitboards
+	void RemovePiece(const int square);
+
+	// Updates both check flags after a move
+	void UpdateChecks();
+
+	// Builds the Zobrist key of the position from scratch
+	// Returns the key the incremental updates should match
+	std::uint64_t ComputeKey() const;
+
+	// Builds the Zobrist key of the pawns from scratch
+	// Returns the key the incremental updates should match
+	std::uint64_t ComputePawnKey() const;
+
+	// Scores the pawn structure and finds the tiles the pawns attack
+	// Fills an entry of the pawn table for the current pawn key
+	void EvaluatePawns(PawnEntry &entry) const;
+
+	// Adds up the piece square values of every piece from scratch, for the midgame or the endgame
+	// Returns the score the incremental updates should match
+	int ComputePieceSquareScore(const GamePhase stage) const;
+
+	// Adds up the phase weight of every piece from scratch
+	// Returns the phase the incremental updates should match
+	int ComputePhase() const;
+
+	// Finds the pieces of a given color (1 for white, -1 for black) that attack a tile, with sliders blocked by a given occupancy
+	// Returns a bitboard of the attacking pieces
+	bitboard Attackers(const int square, const int color, const bitboard occupied) const;
+
+	// Checks if a tile is attacked by a given color (1 for white, -1 for black)
+	bool IsAttacked(const int square, const int color) const
+	{ return Attackers(square, color, occupiedBoard) != 0; }
+
+	// Scores the tiles a piece targets; One point per tile and an extra point per occupied tile
+	int Mobility(const bitboard attacks) const
+	{ return popCount(attacks) + popCount(attacks & occupiedBoard); }
+
+	// Converts a color (1 for white, -1 for black) to a side index for bitboards
+	static int SideIndex(const int color)
+	{ return color == 1 ? 0 : 1; }
 
 	// Checks if a given pair of coordinates are within the bounds of the game board
 	bool InBounds(const unsigned int xCoord, const unsigned int yCoord) const
@@ -119,7 +283,7 @@ protected:
 	// 
 	// Promotion -				When a pawn reaches the opponent's back rank, it may be promoted to any piece besides
 	//							a king. 
-	//							{For simplicity, we'll assume both players will only choose to promote a pawn to a queen}
+	//							{For simplicity, moves entered on the board always promote a pawn to a queen}
 	// 
 	// Fifty Move Rule -		If each player has taken 50 moves (totaling 100) without capture or a pawn move, it is
 	//							declared a draw. Neither player wins.
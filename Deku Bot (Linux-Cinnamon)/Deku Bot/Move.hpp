@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include <string>
+
+// A chess move packed into 16 bits
+// Bits 0-5 -> Initial tile | Bits 6-11 -> Final tile | Bits 12-15 -> Flags
+// Tiles are bitboard indices (x + 8 * y)
+struct Move
+{
+	// Flags describing what kind of move this is
+	// Bit 2 marks captures and bit 3 marks promotions; The low two bits of a promotion hold the new piece
+	enum Flag
+	{
+		Quiet = 0,
+		DoublePush = 1,
+		CastleShort = 2,
+		CastleLong = 3,
+		Capture = 4,
+		EnPassant = 5,
+		Promotion = 8,
+		PromotionCapture = 12
+	};
+
+	// Packed move data; Zero is the null move
+	std::uint16_t data;
+
+	// Default Constructor creates a null move
+	Move() : data(0) {}
+
+	// Explicit Constructor takes the initial tile, final tile and flags of a move
+	Move(const int initial, const int final, const int flags = Quiet)
+		: data((std::uint16_t)(initial | (final << 6) | (flags << 12))) {}
+
+	// Tile the piece starts on
+	int Initial() const
+	{ return data & 63; }
+
+	// Tile the piece ends on
+	int Final() const
+	{ return (data >> 6) & 63; }
+
+	// Flags of the move
+	int Flags() const
+	{ return data >> 12; }
+
+	// Checks if the move takes a piece (including en passant)
+	bool IsCapture() const
+	{ return (Flags() & Capture) != 0; }
+
+	// Checks if the move promotes a pawn
+	bool IsPromotion() const
+	{ return (Flags() & Promotion) != 0; }
+
+	// Checks if the move is a king castling
+	bool IsCastle() const
+	{ return Flags() == CastleShort || Flags() == CastleLong; }
+
+	// Checks if the move takes a pawn en passant
+	bool IsEnPassant() const
+	{ return Flags() == EnPassant; }
+
+	// Checks if the move is a pawn moving two tiles
+	bool IsDoublePush() const
+	{ return Flags() == DoublePush; }
+
+	// Returns the piece a pawn promotes to; Only valid if IsPromotion()
+	PieceType PromotionPiece() const
+	{
+		const PieceType promotions[4] = { Knight, Bishop, Rook, Queen };
+		return promotions[Flags() & 3];
+	}
+
+	// Checks if the move exists
+	bool IsNull() const
+	{ return data == 0; }
+
+	// Writes the move in coordinate notation, such as "e2e4" or "a7a8q"
+	// Returns the notation as a string
+	std::string Notation() const
+	{
+		std::string notation;
+		for (int square : { Initial(), Final() })
+		{
+			notation += (char)('a' + square % 8);
+			notation += (char)('8' - square / 8);
+		}
+
+		if (IsPromotion())
+			notation += "nbrq"[Flags() & 3];
+
+		return notation;
+	}
+
+	bool operator==(const Move& rhs) const
+	{ return data == rhs.data; }
+
+	bool operator!=(const Move& rhs) const
+	{ return data != rhs.data; }
+};
+
+// Fixed capacity list of moves that lives on the stack
+// Move generation fills it in place, so searching never touches the heap
+struct MoveList
+{
+	// No chess position has more than 218 legal moves
+	static const int capacity = 256;
+
+	// Stored moves; Only the first Size() entries are valid
+	Move moves[capacity];
+
+	// Number of stored moves
+	int count = 0;
+
+	// Adds a move to the end of the list
+	void Add(const Move move)
+	{ moves[count++] = move; }
+
+	// Returns the number of moves in the list
+	int Size() const
+	{ return count; }
+
+	// Removes every move from the list
+	void Clear()
+	{ count = 0; }
+
+	Move& operator[](const int index)
+	{ return moves[index]; }
+
+	const Move& operator[](const int index) const
+	{ return moves[index]; }
+
+	// Iterators allow range based for loops
+	Move* begin()
+	{ return moves; }
+
+	Move* end()
+	{ return moves + count; }
+
+	const Move* begin() const
+	{ return moves; }
+
+	const Move* end() const
+	{ return moves + count; }
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include <cstdint>
+#include <memory>
+
+// Everything the evaluation needs that depends on nothing but where the pawns stand
+struct PawnEntry
+{
+	// Pawn key of the structure the entry belongs to
+	std::uint64_t key;
+
+	// Tiles each side's pawns attack towards the left and towards the right of the board
+	// Side 0 -> White | Side 1 -> Black; No two pawns of a side attack the same tile in the same direction
+	bitboard attacks[2][2];
+
+	// White's pawn structure score minus black's, in the midgame and in the endgame
+	int score[2];
+};
+
+// Hash table of pawn structures, indexed by pawn keys
+// Each search thread owns one, so entries are read and written without locks
+// A new entry simply replaces the old one in its slot; Pawn structures rarely change between nodes, so most lookups hit
+class PawnTable
+{
+public:
+	// Default Constructor; Every entry starts out holding the structure without pawns
+	PawnTable();
+
+	// Returns the slot of a pawn key; Holds the structure if its key matches, otherwise the caller fills it in
+	PawnEntry& Slot(const std::uint64_t key)
+	{ return entries[key & (size - 1)]; }
+
+private:
+	// ----- Data Members ----- \\
+
+	// Number of entries; A power of two so a key masks straight to its slot
+	static const int size = 1 << 14;
+
+	std::unique_ptr<PawnEntry[]> entries;
+};
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "GameBoard.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// A node whose remaining moves are shared between threads
+// The thread that reached the node owns it and waits for its helpers before the node is left
+struct SplitPoint
+{
+	// Explicit Constructor takes the board of the node, the split point its owner was working under,
+	// the moves of the node with their ordering scores, and the index of the first move left to search
+	SplitPoint(const GameBoard &game, const SplitPoint *parentSplit, const MoveList &nodeMoves, const int nodeScores[], const int index)
+		: board(game), parent(parentSplit), moves(nodeMoves), nextIndex(index), cutoff(false), workers(0)
+	{
+		for (int i = 0; i < moves.Size(); i++)
+			scores[i] = nodeScores[i];
+	}
+
+	// Checks if the split point lies below another, so its result feeds into the other's
+	bool Descends(const SplitPoint *ancestor) const
+	{
+		for (const SplitPoint *split = parent; split; split = split->parent)
+			if (split == ancestor)
+				return true;
+		return false;
+	}
+
+	// Checks if any move is left to hand out
+	bool HasWork()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return !cutoff && nextIndex < moves.Size();
+	}
+
+	// ----- Data Members ----- \\
+
+	// Longest line from the root a split point can lie on; The deepest ply of the search
+	static const int maxPly = 128;
+
+	// Board of the node before any of its moves
+	const GameBoard board;
+
+	// Split point the owner was working under; A cutoff there makes this one useless too
+	const SplitPoint *parent;
+
+	// Depth left and moves made since the root at the node
+	int depth, ply;
+
+	// Keys of the positions on the line from the root to the node, and which of the moves on it were null moves
+	// Copied from the owner before the node is offered, since the owner rewrites its own line whenever it joins another split point
+	std::array<std::uint64_t, maxPly> lineKeys;
+	std::array<bool, maxPly> lineNullMoves;
+
+	// Whether the AI is the player to move, and whether that player is in check
+	bool aiTurn, inCheck;
+
+	// Guards everything below that changes while threads search the node
+	std::mutex lock;
+
+	// Moves of the node with their ordering scores; Moves before the next index are handed out already
+	MoveList moves;
+	int scores[MoveList::capacity];
+	int nextIndex;
+
+	// Window of the node, narrowed as better moves are found
+	int alpha, beta;
+
+	// Best score and move found so far, and the line that follows the move
+	int bestValue;
+	Move bestMove;
+	MoveList line;
+
+	// Set once a move proves the node will not be played; Every thread below stops searching
+	std::atomic<bool> cutoff;
+
+	// Number of threads other than the owner still searching moves of the node
+	std::atomic<int> workers;
+};
+
+// Split points a thread owns, oldest first
+// The owner adds and removes at the newest end, while other threads take work from the oldest end, where subtrees are largest
+class SplitDeque
+{
+public:
+	// Default Constructor
+	SplitDeque() : size(0) {}
+
+	// Checks if another split point fits; Only the owner adds, so the answer holds until it does
+	bool Full() const
+	{ return size == capacity; }
+
+	// Offers a split point to other threads
+	void Push(SplitPoint *split);
+
+	// Takes back the newest split point so no more threads join it
+	void Pop();
+
+	// Joins the oldest split point that still has moves left; Only those below an ancestor if one is given
+	// Returns the split point with its worker count raised, or null if none could be joined
+	SplitPoint* Steal(const SplitPoint *ancestor);
+
+private:
+	// ----- Data Members ----- \\
+
+	// A thread owns at most one split point per ply
+	static const int capacity = 128;
+
+	// Guards the split points and their size
+	std::mutex lock;
+
+	SplitPoint *points[capacity];
+	int size;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameBoard.hpp"
+#include "DekuBot.hpp"
 
 // White Box Testing Struct
 struct BoardTest : public GameBoard
@@ -8,10 +9,83 @@ struct BoardTest : public GameBoard
 	// Gets the number of calculated moves for a given color (1 -> White | -1 -> Black)
 	int NumberOfMoves(const int color)
 	{
-		return FindMoves(color).size();
+		MoveList moves;
+		FindMoves(color, moves);
+		return moves.Size();
 	}
 };
 
+// White Box Testing Struct
+struct BotTest : public DekuBot
+{
+	// Explicit Constructor takes a reference to an existing game board and the AI's color (1 -> White | -1 -> Black)
+	BotTest(GameBoard* board, const int color) : DekuBot(board, color) {}
+
+	// Searches for a given number of milliseconds and returns the best move found
+	Move Search(const int milliseconds)
+	{
+		maxSearchTime = milliseconds;
+		stopFlag = false;
+
+		MoveList moves;
+		currentGame->FindMoves(aiColor, moves);
+		return breadthFirstSearch(moves);
+	}
+
+	// Returns the score of the move chosen by the last search
+	int Score() const
+	{ return searchScore; }
+
+	// Sets half the width of the first aspiration window of each depth
+	void SetAspirationWindow(const int window)
+	{ aspirationWindow = window; }
+
+	// Turns late move reductions on or off
+	void SetLateMoveReductions(const bool reduce)
+	{ lateMoveReductions = reduce; }
+
+	// Checks if the search would try a null move on a board with a null window around a static fitness
+	bool NullMoveAllowed(const GameBoard& game, const int depth, const int staticFitness)
+	{
+		nullMoveMade[0] = false;
+		return CanNullMove(game, staticFitness - 1, staticFitness, depth, 1, staticFitness);
+	}
+
+	// Records a position as played earlier in the game
+	void RecordGamePosition(const GameBoard& game)
+	{ gameKeys.push_back(game.positionKey()); }
+
+	// Returns the line the last search expects to be played, starting with its best move
+	MoveList PrincipalVariation()
+	{
+		MoveList line;
+		for (int ply = 0; ply < pvLength[0]; ply++)
+			line.Add(pvTable[0][ply]);
+		return line;
+	}
+
+	// Scores a board the way the search does at every node, through the evaluation cache
+	int Evaluate(const GameBoard& game)
+	{ return StaticEvaluation(game); }
+
+	// Scores a board after its captures have played out
+	int Quiescence(GameBoard& game)
+	{ return quiescenceSearch(game, INT32_MIN, INT32_MAX, 0); }
+
+	// Sorts a list of moves into the order the search would try them
+	void OrderMoves(const GameBoard& game, MoveList& moves, const Move hashMove)
+	{
+		int scores[MoveList::capacity];
+		ScoreMoves(game, moves, scores, hashMove, 0);
+
+		for (int i = 0; i < moves.Size(); i++)
+			PickMove(moves, scores, i);
+	}
+};
+
+// Returns the number of heap allocations made since the program started
+long long allocationCount();
+
 // Run all tests
 void runAllTests();
 
@@ -22,4 +96,43 @@ void testBoardConstructor();
 void testBoardFitness();
 
 // Test Movement Method
-void testMoveMethod();
\ No newline at end of file
+void testMoveMethod();
+
+// Test Make / Unmake Methods
+void testUndoMove();
+
+// Test that only legal moves are generated and that the search sees the end of the game
+void testLegalMoves();
+
+// Test Transposition Table Store / Probe Methods
+void testTranspositionTable();
+
+// Test Move Ordering Methods
+void testMoveOrdering();
+
+// Test Quiescence Search
+void testQuiescence();
+
+// Test that the search stops on time without reading the clock every node
+void testSearchStop();
+
+// Test the principal variation kept by the search
+void testPrincipalVariation();
+
+// Test that null moves are only tried where passing can not be the best move
+void testSearchNullMove();
+
+// Test that a window too narrow for the score is widened until the search agrees with a full window
+void testSearchAspiration();
+
+// Test that reduced moves searched again at full depth leave the best move as an unreduced search finds it
+void testSearchReductions();
+
+// Test that searching never allocates memory
+void testSearchAllocations();
+
+// Test that the search scores repetitions and the fifty move rule as draws
+void testDrawDetection();
+
+// Test that cached evaluations match the board's own ranking
+void testEvaluationCache();
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Move.hpp"
+#include <atomic>
+#include <memory>
+
+// Kinds of scores a search can leave in the table
+// Exact -> The true score | Lower -> The score is at least this much | Upper -> The score is at most this much
+enum Bound { NoBound, ExactBound, LowerBound, UpperBound };
+
+// Everything the table remembers about a searched position
+struct TableEntry
+{
+	// Best move found in the position; Null if no move was best
+	Move bestMove;
+
+	// Score of the position from the AI's point of view
+	int score;
+
+	// Depth the position was searched to
+	int depth;
+
+	// How the score relates to the true score
+	Bound bound;
+};
+
+// Shared hash table of searched positions, indexed by Zobrist keys
+// Entries are written without locks; Each stores its key mixed with its data, so a torn write just fails to match
+class TranspositionTable
+{
+public:
+	// Explicit Constructor takes the size of the table in megabytes
+	explicit TranspositionTable(const int megabytes);
+
+	// Reallocates the table to a given size in megabytes, dropping every entry
+	void Resize(const int megabytes);
+
+	// Drops every entry
+	void Clear();
+
+	// Marks the start of a new search so entries from old searches are replaced first
+	void NewSearch()
+	{ generation++; }
+
+	// Looks up a position by its key
+	// Returns true and fills the entry if the position was found
+	bool Probe(const std::uint64_t key, TableEntry& entry) const;
+
+	// Stores the result of searching a position
+	void Store(const std::uint64_t key, const Move bestMove, const int score, const int depth, const Bound bound);
+
+private:
+	// ----- Data Members ----- \\
+
+	// Entries that share a cache line; A key may be stored in any slot of its bucket
+	struct alignas(64) Bucket
+	{
+		static const int slots = 4;
+
+		// Key of each slot mixed with its data
+		std::atomic<std::uint64_t> keys[slots];
+
+		// Packed move, score, depth, bound and generation of each slot
+		std::atomic<std::uint64_t> data[slots];
+	};
+
+	// Buckets of the table; The count is a power of two so a key masks straight to its bucket
+	std::unique_ptr<Bucket[]> buckets;
+	std::uint64_t bucketMask;
+
+	// Number of the current search, stored with each entry to tell its age
+	std::uint8_t generation;
+};
\ No newline at end of file
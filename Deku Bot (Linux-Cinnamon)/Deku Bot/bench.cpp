@@ -0,0 +1,86 @@
+#include "DekuBot.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Positions searched to measure how the time to reach a depth scales with the number of threads
+static const char* benchPositions[] = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+};
+
+// Gives the benchmark access to the search of the bot
+class BenchBot : public DekuBot
+{
+public:
+	// Plays the side to move of a board with a fresh table
+	BenchBot(GameBoard* board, const int threads, const ParallelSearch mode) : DekuBot(board, board->whosTurn() ? 1 : -1, 64)
+	{
+		SetParallelSearch(mode);
+		SetThreads(threads);
+	}
+
+	// Searches the board until a given depth is finished
+	// Returns the time taken in seconds
+	double TimeToDepth(const int depth)
+	{
+		MoveList moves;
+		currentGame->FindMoves(aiColor, moves);
+
+		SetDepthLimit(depth);
+		maxSearchTime = INT32_MAX;
+		stopFlag = false;
+
+		auto start = std::chrono::steady_clock::now();
+		breadthFirstSearch(moves);
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+// Searches every position to a given depth with a given number of threads
+// Returns the total time taken in seconds
+static double timeToDepth(const int depth, const int threads, const ParallelSearch mode)
+{
+	double seconds = 0;
+
+	for (auto fen : benchPositions)
+	{
+		GameBoard board(fen);
+		BenchBot bot(&board, threads, mode);
+		seconds += bot.TimeToDepth(depth);
+	}
+
+	return seconds;
+}
+
+// ./bench [depth] [threads] [lazy|split]
+// Times the search of every position to a depth with 1, 2, 4... threads, up to the number of cores by default
+// Threads share the work with Lazy SMP unless split points are asked for
+int main(int argc, char* argv[])
+{
+	int depth = (argc > 1) ? std::stoi(argv[1]) : 9;
+	int maxThreads = (argc > 2) ? std::stoi(argv[2]) : (int)std::thread::hardware_concurrency();
+	if (maxThreads < 1)
+		maxThreads = 1;
+
+	ParallelSearch mode = (argc > 3 && std::string(argv[3]) == "split") ? SplitPoints : LazySMP;
+
+	// Thread counts to measure; Doubling each time, ending on the largest
+	int counts[32], numCounts = 0;
+	for (int threads = 1; threads < maxThreads && numCounts < 31; threads *= 2)
+		counts[numCounts++] = threads;
+	counts[numCounts++] = maxThreads;
+
+	double times[32];
+	for (int i = 0; i < numCounts; i++)
+		times[i] = timeToDepth(depth, counts[i], mode);
+
+	std::cout << std::endl << "Time To Depth " << depth << ((mode == SplitPoints) ? " | Split Points" : " | Lazy SMP") << std::endl;
+	for (int i = 0; i < numCounts; i++)
+		std::cout << "Threads: " << counts[i] << " | Time: " << times[i] << "s | Speedup: " << times[0] / times[i] << "x" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
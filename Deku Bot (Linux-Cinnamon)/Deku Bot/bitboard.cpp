@@ -0,0 +1,170 @@
+#include "Bitboard.hpp"
+
+// Precomputed attacks of the pieces that do not slide
+bitboard pawnTable[2][64], knightTable[64], kingTable[64];
+
+// Tiles between and through every pair of aligned tiles
+bitboard betweenTable[64][64], lineTable[64][64];
+
+// Magic lookups for rooks and bishops on each tile
+Magic rookMagics[64], bishopMagics[64];
+
+// Shared attack tables the magic lookups point into
+// Sized to the sum of 2^(relevant tiles) over every square
+static bitboard rookTable[102400], bishopTable[5248];
+
+// Walks a ray from a tile until it leaves the board or hits an occupied tile
+static bitboard slide(const int square, const bitboard occupied, bitboard (*step)(const bitboard), bitboard (*turn)(const bitboard))
+{
+	bitboard attacks = 0;
+	bitboard ray = squareMask(square);
+
+	while (ray)
+	{
+		ray = step(ray);
+		if (turn)
+			ray = turn(ray);
+
+		attacks |= ray;
+
+		if (ray & occupied)
+			break;
+	}
+
+	return attacks;
+}
+
+// Rook attacks found by walking each ray; Only used to fill the magic tables
+static bitboard slideRook(const int square, const bitboard occupied)
+{
+	return slide(square, occupied, shiftUp, nullptr) | slide(square, occupied, shiftDown, nullptr)
+		| slide(square, occupied, shiftLeft, nullptr) | slide(square, occupied, shiftRight, nullptr);
+}
+
+// Bishop attacks found by walking each ray; Only used to fill the magic tables
+static bitboard slideBishop(const int square, const bitboard occupied)
+{
+	return slide(square, occupied, shiftUp, shiftLeft) | slide(square, occupied, shiftUp, shiftRight)
+		| slide(square, occupied, shiftDown, shiftLeft) | slide(square, occupied, shiftDown, shiftRight);
+}
+
+// Returns a random number with few bits set; Sparse numbers make good magic candidates
+static bitboard sparseRandom(bitboard& seed)
+{
+	bitboard number = ~0ULL;
+
+	for (int i = 0; i < 3; i++)
+	{
+		// Xorshift generator
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		number &= seed * 2685821657736338717ULL;
+	}
+
+	return number;
+}
+
+// Finds a magic number for every tile of a sliding piece and fills its attack table
+static void findMagics(Magic (&magics)[64], bitboard* table, bitboard (*slider)(const int, const bitboard))
+{
+	// Fixed seed so every run builds the same tables
+	bitboard seed = 0x9E3779B97F4A7C15ULL;
+
+	// Every occupancy of a tile and the attacks it produces
+	bitboard occupancies[4096], attacks[4096];
+
+	// Tracks which attempt last wrote each table entry, so entries need not be cleared between attempts
+	int epoch[4096] = { 0 }, attempt = 0;
+
+	for (int square = 0; square < 64; square++)
+	{
+		Magic& magic = magics[square];
+
+		// Tiles on the board edge never block a ray unless the slider stands on that edge
+		bitboard edges = ((rowMask(0) | rowMask(7)) & ~rowMask(square / 8))
+			| ((leftColumn | rightColumn) & ~(leftColumn << (square % 8)));
+
+		magic.mask = slider(square, 0) & ~edges;
+		magic.shift = 64 - popCount(magic.mask);
+		magic.attacks = table;
+
+		// Enumerate every subset of the mask
+		int size = 0;
+		bitboard subset = 0;
+		do
+		{
+			occupancies[size] = subset;
+			attacks[size] = slider(square, subset);
+			size++;
+			subset = (subset - magic.mask) & magic.mask;
+		} while (subset);
+
+		// Try random numbers until one maps every occupancy without a harmful collision
+		for (int i = 0; i < size; )
+		{
+			do
+				magic.number = sparseRandom(seed);
+			while (popCount((magic.mask * magic.number) >> 56) < 6);
+
+			attempt++;
+			for (i = 0; i < size; i++)
+			{
+				unsigned int index = (unsigned int)(((occupancies[i] & magic.mask) * magic.number) >> magic.shift);
+
+				// Two occupancies may share an entry only if they produce the same attacks
+				if (epoch[index] < attempt)
+				{
+					epoch[index] = attempt;
+					table[index] = attacks[i];
+				}
+				else if (table[index] != attacks[i])
+					break;
+			}
+		}
+
+		// The next tile's table starts after this one
+		table += size;
+	}
+}
+
+// Fills the attack tables once at program start
+static bool buildTables()
+{
+	for (int square = 0; square < 64; square++)
+	{
+		bitboard tile = squareMask(square);
+
+		// Pawns attack diagonally forwards
+		pawnTable[0][square] = shiftLeft(shiftUp(tile)) | shiftRight(shiftUp(tile));
+		pawnTable[1][square] = shiftLeft(shiftDown(tile)) | shiftRight(shiftDown(tile));
+
+		// Knights move two tiles one way and one tile the other
+		bitboard vertical = shiftUp(shiftUp(tile)) | shiftDown(shiftDown(tile));
+		bitboard horizontal = shiftLeft(shiftLeft(tile)) | shiftRight(shiftRight(tile));
+		knightTable[square] = shiftLeft(vertical) | shiftRight(vertical) | shiftUp(horizontal) | shiftDown(horizontal);
+
+		// Kings move one tile in any direction
+		bitboard row = tile | shiftLeft(tile) | shiftRight(tile);
+		kingTable[square] = (row | shiftUp(row) | shiftDown(row)) & ~tile;
+	}
+
+	// Sliding pieces
+	findMagics(rookMagics, rookTable, slideRook);
+	findMagics(bishopMagics, bishopTable, slideBishop);
+
+	// Lines between aligned tiles, found where the rays of both tiles overlap
+	bitboard (*sliders[2])(const int, const bitboard) = { slideRook, slideBishop };
+	for (int from = 0; from < 64; from++)
+		for (int to = 0; to < 64; to++)
+			for (auto slider : sliders)
+				if (from != to && (slider(from, 0) & squareMask(to)))
+				{
+					betweenTable[from][to] = slider(from, squareMask(to)) & slider(to, squareMask(from));
+					lineTable[from][to] = (slider(from, 0) & slider(to, 0)) | squareMask(from) | squareMask(to);
+				}
+
+	return true;
+}
+
+static const bool tablesBuilt = buildTables();
\ No newline at end of file
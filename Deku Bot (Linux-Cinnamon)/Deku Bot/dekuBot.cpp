@@ -1,155 +1,1129 @@
 #include "DekuBot.hpp"
 
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <thread>
+
+// Worth of each value in the key when ordering captures; Kings are never taken, so they only ever attack
+static const int orderValues[10] = { 0, 1, 1, 5, 5, 3, 3, 9, 20, 20 };
+
+// Worth of each piece type a pawn may promote to
+static const int promotionValues[6] = { 0, 5, 3, 3, 9, 0 };
+
+// Most each value in the key can add to the fitness of the player that takes it, counting the mobility it held
+// Captures that can not lift the fitness to the window even with this much, and a margin, are skipped in quiescence
+static const int deltaValues[10] = { 0, 10, 10, 30, 30, 30, 30, 60, 0, 0 };
+static const int deltaMargin = 20;
+
+// Depth taken off late quiet moves, by depth left and number of moves tried before; Grows with the log of both
+static int reductions[64][MoveList::capacity];
+
+// Fills the reductions once at program start
+static bool buildReductions()
+{
+	for (int depth = 0; depth < 64; depth++)
+		for (int index = 0; index < MoveList::capacity; index++)
+			reductions[depth][index] = (depth > 0 && index > 0) ? (int)(0.75 + std::log(depth) * std::log(index) / 2.25) : 0;
+
+	return true;
+}
+
+static const bool reductionsBuilt = buildReductions();
+
+// Checks if a window holds just one score, as it does everywhere off the principal variation
+// The width is taken in 64 bits, since an open window spans every int
+static bool isNullWindow(const int alpha, const int beta)
+{
+	return (std::int64_t)beta - alpha == 1;
+}
+
+// Ordering scores of each kind of move; Every capture is tried before every killer, and every killer before every other quiet move
+static const int hashMoveScore = 1000000;
+static const int captureScore = 200000;
+static const int killerScore = 100000;
 
 // Explicit Constructor
-DekuBot::DekuBot(GameBoard* board, const int color)
+DekuBot::DekuBot(GameBoard* board, const int color, const int hashMegabytes, const int threads)
+	: ownedTable(new TranspositionTable(hashMegabytes)), table(*ownedTable), stopFlag(ownedStopFlag)
 {
 	currentGame = board;
 	aiColor = color;
 	maxSearchTime = 0;
+	gameOver = false;
+	quiescenceEvasions = true;
+	lateMoveReductions = true;
+	aspirationWindow = 25;
+	searchScore = 0;
+	stopFlag = false;
+	nodes = 0;
+	depthLimit = 0;
+	threadIndex = 0;
+	master = this;
+	parallelMode = LazySMP;
+	idleWorkers = 0;
+	activeSplit = nullptr;
+
+	// Nothing has been learned about move ordering yet
+	for (int side = 0; side < 2; side++)
+		for (int from = 0; from < 64; from++)
+			for (int to = 0; to < 64; to++)
+				history[side][from][to] = 0;
+
+	// No line has been found yet
+	for (int ply = 0; ply < maxPly; ply++)
+	{
+		nullMoveMade[ply] = false;
+		pvLength[ply] = 0;
+		for (int next = 0; next < maxPly; next++)
+			pvTable[ply][next] = Move();
+	}
+
+	cutoffs = firstMoveCutoffs = 0;
+
+	// Room for every position that can still repeat, so recording the game never allocates during play
+	gameKeys.reserve(fiftyMoveLimit + 2);
+
+	SetThreads(threads);
+}
+
+// Helper Constructor; Shares the board, table and stop flag of the main bot
+DekuBot::DekuBot(DekuBot& master, const int index) : table(master.table), stopFlag(master.stopFlag)
+{
+	currentGame = master.currentGame;
+	aiColor = master.aiColor;
+	maxSearchTime = master.maxSearchTime;
+	gameOver = false;
+	quiescenceEvasions = master.quiescenceEvasions;
+	lateMoveReductions = master.lateMoveReductions;
+	aspirationWindow = master.aspirationWindow;
+	searchScore = 0;
+	ownedStopFlag = false;
+	nodes = 0;
+	depthLimit = 0;
+	threadIndex = index;
+	this->master = &master;
+	parallelMode = master.parallelMode;
+	idleWorkers = 0;
+	activeSplit = nullptr;
+
+	for (int side = 0; side < 2; side++)
+		for (int from = 0; from < 64; from++)
+			for (int to = 0; to < 64; to++)
+				history[side][from][to] = 0;
+
+	// No line has been found yet
+	for (int ply = 0; ply < maxPly; ply++)
+	{
+		nullMoveMade[ply] = false;
+		pvLength[ply] = 0;
+		for (int next = 0; next < maxPly; next++)
+			pvTable[ply][next] = Move();
+	}
+
+	cutoffs = firstMoveCutoffs = 0;
+}
+
+// Sets the number of threads that search together; Helper threads share the transposition table
+void DekuBot::SetThreads(const int threads)
+{
+	helpers.clear();
+	for (int index = 1; index < threads; index++)
+		helpers.emplace_back(new DekuBot(*this, index));
+}
+
+// Limits how deep each search may go; Zero searches until time runs out
+void DekuBot::SetDepthLimit(const int depth)
+{
+	depthLimit = depth;
+}
+
+// Sets how the threads of a search share the work
+void DekuBot::SetParallelSearch(const ParallelSearch mode)
+{
+	parallelMode = mode;
 }
 
 // Makes a move on the chess board
 void DekuBot::MakeMove(int maxTime)
 {
+	// The result of a finished game is only announced once
+	if (gameOver)
+		return;
+
+	// A new search may run; Cleared here rather than inside the search, so a Stop from then on is never lost
+	stopFlag = false;
+
 	// Find all possible moves
-	auto moves = currentGame->FindMoves(aiColor);
+	MoveList moves;
+	currentGame->FindMoves(aiColor, moves);
+
+	// With no legal moves left the game is over
+	if (moves.Size() == 0)
+	{
+		bool inCheck = (aiColor == 1) ? currentGame->isWhiteInCheck() : currentGame->isBlackInCheck();
+		std::cout << (inCheck ? "Checkmate - You Win" : "Stalemate") << std::endl;
+		gameOver = true;
+		return;
+	}
 
 	// Calculate the maximum ammount of time the AI may search for
 	maxSearchTime = maxTime * 60000;
 
 	// Best Move
-	std::pair<coordinates, coordinates> bestMove = breadthFirstSearch(moves);
+	Move bestMove = breadthFirstSearch(moves);
+
+	// Preform the best move; It came from FindMoves so it needs no checking
+	if (!bestMove.IsNull())
+	{
+		currentGame->ApplyMove(bestMove);
+		gameKeys.push_back(currentGame->positionKey());
+	}
+}
 
-	// Preform the best move
-	currentGame->MovePiece(bestMove.first, bestMove.second);
+// Asks a running search to stop as soon as possible
+// Safe to call from another thread, such as the GUI
+void DekuBot::Stop()
+{
+	stopFlag.store(true, std::memory_order_relaxed);
 }
 
 // Search the tree Breadth First
 // Returns the best move after a given amount of time
-std::pair<coordinates, coordinates> DekuBot::breadthFirstSearch(std::vector<std::pair<coordinates, coordinates>>& moves)
+Move DekuBot::breadthFirstSearch(MoveList& moves)
 {
-	std::pair<coordinates, coordinates> bestMove;
-	bestMove.first = coordinates(-1, -1);
-	bestMove.second = coordinates(-1, -1);
+	// Best move and score of the deepest search that can be trusted
+	Move bestMove;
 	int bestScore = INT32_MIN;
-	int newScore = 0;
-	int depth = 1;
 
-	auto maxSearchDuration = std::chrono::milliseconds(maxSearchTime);
-    auto endTime = std::chrono::high_resolution_clock::now() + maxSearchDuration;
+	// Start the clock; The search polls it every few thousand nodes and stops itself once time is up
+	// Helpers are handed the clock and table of the main thread instead
+	if (threadIndex == 0)
+	{
+		deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxSearchTime);
+
+		// Entries from earlier moves may still be used, but are replaced first
+		table.NewSearch();
+
+		// Record the root as the latest position of the game, dropping those before the last capture or pawn move
+		std::uint64_t rootKey = currentGame->positionKey();
+		if (!gameKeys.empty() && gameKeys.back() == rootKey)
+			gameKeys.pop_back();
+
+		int reversible = currentGame->numMovesSinceCapture();
+		if (reversible > fiftyMoveLimit)
+			reversible = fiftyMoveLimit;
+		if ((int)gameKeys.size() > reversible)
+			gameKeys.erase(gameKeys.begin(), gameKeys.end() - reversible);
+		gameKeys.push_back(rootKey);
+	}
+	nodes = 0;
+
+	// Single board the whole search makes and takes back moves on
+	GameBoard board = *currentGame;
+	positionKeys[0] = board.positionKey();
+
+	// The root is never reached by a null move, so the first ply may always try one
+	nullMoveMade[0] = false;
+
+	AgeMoveOrdering();
+	pvLength[0] = 0;
+
+	// Score and subtree size of each root move in the last depth, used to order the next depth
+	int rootScores[MoveList::capacity];
+	long long rootNodes[MoveList::capacity];
+	for (int i = 0; i < moves.Size(); i++)
+	{
+		rootScores[i] = 0;
+		rootNodes[i] = 0;
+	}
+
+	// Lazy SMP; Helpers search the same root on their own threads, sharing what they learn only through the table
+	// Every other helper starts one depth deeper, so the threads spread over different depths instead of repeating each other
+	// Split Points; Helpers wait for nodes to share instead, and search only the moves they are handed
+	std::vector<std::thread> threads;
+	threads.reserve(helpers.size());
+	idleWorkers = (parallelMode == SplitPoints) ? (int)helpers.size() : 0;
+	for (auto& helper : helpers)
+	{
+		helper->currentGame = currentGame;
+		helper->maxSearchTime = maxSearchTime;
+		helper->deadline = deadline;
+		helper->quiescenceEvasions = quiescenceEvasions;
+		helper->lateMoveReductions = lateMoveReductions;
+		helper->aspirationWindow = aspirationWindow;
 
-    while (std::chrono::high_resolution_clock::now() < endTime)
+		if (parallelMode == SplitPoints)
+			threads.emplace_back([&helper]() { helper->WaitForWork(); });
+		else
+			threads.emplace_back([&helper, moves]() mutable { helper->breadthFirstSearch(moves); });
+	}
+
+	// Depths stop short of the ply limit, past which the search tables have no room
+	for (int depth = 1 + threadIndex % 2; depth < maxPly && !stopFlag && std::chrono::steady_clock::now() < deadline && (depthLimit == 0 || depth <= depthLimit); depth++)
 	{
-		// Evaluate each possible move
-		for (auto& move : moves)
+		// The best move of the last depth goes first, so a depth that is cut short can still be measured against it
+		// The rest follow by score, then by how much work their subtrees took
+		OrderRootMoves(moves, rootScores, rootNodes, bestMove);
+
+		// Aspiration window; Expect the score to stay near the last depth's, and widen the window whenever it does not
+		int window = aspirationWindow;
+		int alpha = INT32_MIN, beta = INT32_MAX;
+		if (depth > 1 && bestScore > -1000 && bestScore < 1000)
 		{
-			// Create a copy of the current game board
-			GameBoard copy = *currentGame;
-			// Preform the move on the copy
-			copy.MovePiece(move.first, move.second);
-			// Evaluate the result of that move
-			newScore = miniMaxMove(copy, INT32_MIN, INT32_MAX, depth, endTime);
+			alpha = bestScore - window;
+			beta = bestScore + window;
+		}
+
+		Move depthMove;
+		int depthScore = INT32_MIN;
 
-			// Store the best move
-			if (newScore > bestScore)
-			{
-				bestScore = newScore;
-				bestMove.first = move.first;
-				bestMove.second = move.second;
-			}
+		while (true)
+		{
+			depthScore = rootSearch(board, moves, alpha, beta, depth, depthMove, rootScores, rootNodes);
+
+			if (stopFlag)
+				break;
+
+			// Search again with a wider window on the side that failed; Past mate scores the window opens fully
+			window *= 2;
+			if (depthScore <= alpha)
+				alpha = (window < 1000) ? bestScore - window : INT32_MIN;
+			else if (depthScore >= beta)
+				beta = (window < 1000) ? bestScore + window : INT32_MAX;
+			else
+				break;
 		}
 
-		depth++;
+		// A finished depth, or a cut short depth whose best move beat the window, replaces the last result
+		// Scores at or below alpha only say every move was worse, so they can not be trusted
+		if (!depthMove.IsNull() && depthScore > alpha)
+		{
+			bestMove = depthMove;
+			bestScore = depthScore;
+
+			if (threadIndex == 0)
+				PrintPrincipalVariation(depth, bestScore);
+		}
+
+		// A finished depth that proves a mate can not be improved on, since a shorter mate would have shown at a shallower depth
+		if (!stopFlag && (bestScore >= 1000 || bestScore <= -1000))
+			break;
 	}
-	
+
+	// Helpers only ever fill the table; The main thread alone decides the move
+	if (threadIndex != 0)
+		return bestMove;
+
+	// Helpers stop along with the main thread
+	if (!threads.empty())
+	{
+		stopFlag = true;
+		for (auto& thread : threads)
+			thread.join();
+
+		// Nodes searched by every thread together
+		long long totalNodes = nodes;
+		for (auto& helper : helpers)
+			totalNodes += helper->nodes;
+
+		auto elapsed = std::chrono::steady_clock::now() - (deadline - std::chrono::milliseconds(maxSearchTime));
+		double seconds = std::chrono::duration<double>(elapsed).count();
+		std::cout << "Threads " << threads.size() + 1 << " | Total Nodes " << totalNodes << " | NPS " << (long long)(totalNodes / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+	}
+
+	// Time ran out before a single move was searched
+	if (bestMove.IsNull())
+	{
+		bestMove = moves[0];
+		bestScore = 0;
+	}
+	searchScore = bestScore;
+
 	// For fun, calculate confidence of move
 	bestScore += 1000;
 	bestScore *= 100;
 	float confidence = bestScore / 2000.f;
 	std::cout << "Confidence: " << confidence << "%" << std::endl;
 
+	// Share of cutoffs made by the first move tried; The closer to 100%, the better the move ordering
+	if (cutoffs > 0)
+		std::cout << "First Move Cutoffs: " << 100.f * firstMoveCutoffs / cutoffs << "%" << std::endl;
+
 	return bestMove;
 }
 
+// Searches every root move to a given depth within a window; The first move gets the full window, the rest a null window
+// Fills the best move found, along with the score and subtree size of each move
+// Returns the best score found
+int DekuBot::rootSearch(GameBoard& board, MoveList& moves, int alpha, int beta, const int depth, Move& depthMove, int rootScores[], long long rootNodes[])
+{
+	int depthScore = INT32_MIN;
+	depthMove = Move();
+
+	// Evaluate each possible move
+	for (int i = 0; i < moves.Size(); i++)
+	{
+		Move move = moves[i];
+		long long nodesBefore = nodes;
+
+		// Preform the move on the search board
+		UndoRecord undo;
+		board.DoMove(move, undo);
+
+		// Evaluate the result of that move; Later moves only need to show they are no better than the best so far
+		// If one is, search it again for its exact score
+		int newScore;
+		if (i == 0)
+			newScore = miniMaxMove(board, alpha, beta, depth, 1);
+		else
+		{
+			newScore = miniMaxMove(board, alpha, alpha + 1, depth, 1);
+			if (newScore > alpha && newScore < beta)
+				newScore = miniMaxMove(board, alpha, beta, depth, 1);
+		}
+
+		// Take the move back
+		board.UndoMove(move, undo);
+
+		// A move whose search was cut short has no score
+		if (stopFlag)
+			break;
+
+		rootScores[i] = newScore;
+		rootNodes[i] = nodes - nodesBefore;
+
+		// Store the best move, and the line that follows it if the score is inside the window
+		if (newScore > depthScore)
+		{
+			depthScore = newScore;
+			depthMove = move;
+		}
+
+		if (depthScore > alpha)
+		{
+			alpha = depthScore;
+			UpdatePrincipalVariation(0, move);
+		}
+
+		// The score is already above the window, so the window has to widen anyway
+		if (alpha >= beta)
+			break;
+	}
+
+	return depthScore;
+}
+
 // Recursively find the best possible outcome for a move
 // Returns an integer
-int DekuBot::miniMaxMove(GameBoard& nextGame, int alpha, int beta, int currentDepth, std::chrono::_V2::system_clock::time_point endTime)
+int DekuBot::miniMaxMove(GameBoard& nextGame, int alpha, int beta, int currentDepth, int ply)
 {
+	// The line from this node is empty until a move proves best, so no return below hands its parent a stale line
+	if (ply < maxPly)
+		pvLength[ply] = ply;
+
+	// A drawn position scores nothing, however much could still be searched from it
+	// Lines that only shuffle back to an earlier position are cut off here
+	if (IsDraw(nextGame, ply))
+		return 0;
+
+	// Return Leaf Node once the captures on it have played out
+	if (currentDepth <= 0 || ply >= maxPly)
+		return quiescenceSearch(nextGame, alpha, beta, ply);
+
+	positionKeys[ply] = nextGame.positionKey();
+
 	// Calculate fitness of current board
-	int fitness = nextGame.RankBoard(aiColor);
+	int fitness = StaticEvaluation(nextGame);
+	int staticFitness = fitness;
 
 	// Bias fitness based on depth of search
 	if (aiColor == 1 && nextGame.whosTurn() || aiColor == -1 && !nextGame.whosTurn())
 		fitness += currentDepth;
 	fitness -= currentDepth;
 
-	// Return Leaf Node
-	if (currentDepth <= 0)
+	// Unwind once the search has to stop; The score is thrown away by every caller
+	if (ShouldStop())
+		return 0;
+
+	// Return if a king is missing from the board
+	if (fitness >= 1000 || fitness <= -1000)
 		return fitness;
 
-	// Return invalid if search time was reached
-	if (std::chrono::high_resolution_clock::now() >= endTime)
+	// Reuse the result of an earlier search of this position if it went deep enough and settles the score here
+	// Otherwise its best move is still the best guess of what to search first
+	TableEntry entry;
+	Move hashMove;
+	if (table.Probe(nextGame.positionKey(), entry))
 	{
-		if (aiColor == 1 && nextGame.whosTurn() || aiColor == -1 && !nextGame.whosTurn())
-			return INT32_MAX;
+		if (entry.depth >= currentDepth && (entry.bound == ExactBound
+			|| (entry.bound == LowerBound && entry.score >= beta)
+			|| (entry.bound == UpperBound && entry.score <= alpha)))
+			return entry.score;
 
-		return INT32_MIN;
+		hashMove = entry.bestMove;
 	}
 
-	// Return if checkmate was reached
-	if (fitness >= 1000 || fitness <= -1000)
-		return fitness;
+	// Window the children are searched with; Decides what kind of bound the result is
+	int originalAlpha = alpha, originalBeta = beta;
+	Move bestMove;
 
+	bool aiTurn = aiColor == 1 && nextGame.whosTurn() || aiColor == -1 && !nextGame.whosTurn();
+	bool draw = nextGame.isWhiteInCheck() && nextGame.isBlackInCheck();
+	bool inCheck = !draw && (nextGame.whosTurn() ? nextGame.isWhiteInCheck() : nextGame.isBlackInCheck());
 
-	// Find best move if it is AI's turn
-	if (aiColor == 1 && nextGame.whosTurn() || aiColor == -1 && !nextGame.whosTurn())
+	// Null move pruning; If passing the turn still leaves the score past the window, a real move will too
+	nullMoveMade[ply] = false;
+	if (CanNullMove(nextGame, alpha, beta, currentDepth, ply, staticFitness))
 	{
-		int maxValue = INT32_MIN;
+		int reduction = (currentDepth >= 6) ? 3 : 2;
 
-		for (auto& move : nextGame.FindMoves(aiColor))
+		UndoRecord undo;
+		nullMoveMade[ply] = true;
+		nextGame.DoNullMove(undo);
+		int nullValue = miniMaxMove(nextGame, alpha, beta, currentDepth - 1 - reduction, ply + 1);
+		nextGame.UndoNullMove(undo);
+		nullMoveMade[ply] = false;
+
+		if (Aborted())
+			return 0;
+
+		// Mate scores found after passing are not real, so only the bound is returned
+		if (aiTurn && nullValue >= beta)
+			return beta;
+		if (!aiTurn && nullValue <= alpha)
+			return alpha;
+	}
+
+	// Find every legal move of the player whose turn it is
+	MoveList moves;
+	nextGame.FindMoves(aiTurn ? aiColor : -aiColor, moves);
+
+	// A player without moves is checkmated if their king is attacked, otherwise it is a stalemate
+	if (moves.Size() == 0)
+	{
+		if (!inCheck)
+			return 0;
+
+		// Mates found with more depth left are closer to the root, so prefer giving them early and taking them late
+		return aiTurn ? -1000 - currentDepth : 1000 + currentDepth;
+	}
+
+	// Order the moves so the ones most likely to cut the search short come first
+	int scores[MoveList::capacity];
+	ScoreMoves(nextGame, moves, scores, hashMove, ply);
+
+	// Find best move if it is AI's turn, and worst move if it is player's turn
+	int bestValue = aiTurn ? INT32_MIN : INT32_MAX;
+
+	for (int i = 0; i < moves.Size(); i++)
+	{
+		// Young Brothers Wait; Once the eldest move has set the window, idle threads may help search its brothers
+		if (i > 0 && CanSplit(currentDepth))
 		{
-			GameBoard copy = nextGame;
+			SplitNode(nextGame, moves, scores, i, alpha, beta, bestValue, bestMove, currentDepth, ply, aiTurn, inCheck);
+			if (Aborted())
+				return 0;
+			break;
+		}
 
-			copy.MovePiece(move.first, move.second);
-			int newValue = miniMaxMove(copy, alpha, beta, currentDepth - 1, endTime);
-			
-			if (newValue > maxValue)
-				maxValue = newValue;
+		Move move = PickMove(moves, scores, i);
+		int newValue = searchMove(nextGame, move, i, scores[i], alpha, beta, currentDepth, ply, aiTurn, inCheck);
 
-			if (maxValue > alpha)
-				alpha = maxValue;
+		// Results of a search cut short are never used
+		if (Aborted())
+			return 0;
 
-			if (beta <= alpha)
-				break;
+		if (aiTurn ? newValue > bestValue : newValue < bestValue)
+		{
+			bestValue = newValue;
+			bestMove = move;
+			UpdatePrincipalVariation(ply, move);
+		}
+
+		if (aiTurn && bestValue > alpha)
+			alpha = bestValue;
+		if (!aiTurn && bestValue < beta)
+			beta = bestValue;
+
+		if (beta <= alpha)
+		{
+			RecordCutoff(nextGame, move, i, currentDepth, ply);
+			break;
 		}
+	}
+
+	StoreResult(nextGame, bestMove, bestValue, currentDepth, originalAlpha, originalBeta);
+	return bestValue;
+}
+
+// Makes a move and searches it with the window of its node, then takes it back
+// Takes the index and ordering score of the move, which decide how much its depth may be reduced
+// Returns the score of the move
+int DekuBot::searchMove(GameBoard& nextGame, const Move move, const int index, const int score, int alpha, int beta, const int currentDepth, const int ply, const bool aiTurn, const bool inCheck)
+{
+	// Nodes stop searching once their window closes, so the null windows below never reach past an open bound
+	// Their bounds are built by adding to alpha or taking from beta, never from the width of the window
+	assert(alpha < beta);
 
-		return maxValue;
+	UndoRecord undo;
+	nextGame.DoMove(move, undo);
+
+	// Late move reductions; Quiet moves ordered late rarely matter, so search them shallower first
+	// Captures, promotions, killers, checks and escapes from check keep their full depth
+	bool givesCheck = nextGame.whosTurn() ? nextGame.isWhiteInCheck() : nextGame.isBlackInCheck();
+	int reduction = 0;
+	if (lateMoveReductions && index >= 3 && currentDepth >= 3 && !inCheck && !givesCheck && score < killerScore)
+	{
+		reduction = reductions[currentDepth < 64 ? currentDepth : 63][index];
+		if (reduction > currentDepth - 2)
+			reduction = currentDepth - 2;
 	}
 
-	// Find worst move if it is player's turn
+	// Principal Variation Search; The first move gets the full window, the rest only need to show they are no better
+	// A move that is better after all is searched again at full depth, then with the full window for its exact score
+	int newValue;
+	if (index == 0)
+		newValue = miniMaxMove(nextGame, alpha, beta, currentDepth - 1, ply + 1);
+	else if (aiTurn)
+	{
+		newValue = miniMaxMove(nextGame, alpha, alpha + 1, currentDepth - 1 - reduction, ply + 1);
+		if (reduction > 0 && newValue > alpha)
+			newValue = miniMaxMove(nextGame, alpha, alpha + 1, currentDepth - 1, ply + 1);
+		if (newValue > alpha && newValue < beta)
+			newValue = miniMaxMove(nextGame, alpha, beta, currentDepth - 1, ply + 1);
+	}
 	else
 	{
-		int minValue = INT32_MAX;
+		newValue = miniMaxMove(nextGame, beta - 1, beta, currentDepth - 1 - reduction, ply + 1);
+		if (reduction > 0 && newValue < beta)
+			newValue = miniMaxMove(nextGame, beta - 1, beta, currentDepth - 1, ply + 1);
+		if (newValue < beta && newValue > alpha)
+			newValue = miniMaxMove(nextGame, alpha, beta, currentDepth - 1, ply + 1);
+	}
+
+	nextGame.UndoMove(move, undo);
+	return newValue;
+}
+
+// Searches only captures and promotions until the position is quiet, so a leaf is never judged mid exchange
+// Returns an integer
+int DekuBot::quiescenceSearch(GameBoard& nextGame, int alpha, int beta, int ply)
+{
+	bool aiTurn = aiColor == 1 && nextGame.whosTurn() || aiColor == -1 && !nextGame.whosTurn();
+	bool draw = nextGame.isWhiteInCheck() && nextGame.isBlackInCheck();
+	bool inCheck = !draw && (nextGame.whosTurn() ? nextGame.isWhiteInCheck() : nextGame.isBlackInCheck());
+
+	// Captures are not part of the principal variation
+	if (ply < maxPly)
+		pvLength[ply] = ply;
+
+	// The player to move may always stand pat instead of capturing, unless they have to escape check
+	int standPat = StaticEvaluation(nextGame);
+	if (draw || ply >= maxPly)
+		return standPat;
+	if (ShouldStop())
+		return 0;
+
+	bool evading = inCheck && quiescenceEvasions;
+	if (!evading)
+	{
+		if (aiTurn ? standPat >= beta : standPat <= alpha)
+			return standPat;
 
-		for (auto& move : nextGame.FindMoves(-aiColor))
+		if (aiTurn && standPat > alpha)
+			alpha = standPat;
+		if (!aiTurn && standPat < beta)
+			beta = standPat;
+	}
+
+	// Only the loud moves are generated, except in check where every escape is needed to tell a checkmate
+	MoveList moves;
+	nextGame.FindMoves(aiTurn ? aiColor : -aiColor, moves, !inCheck);
+
+	// A player in check without moves is checkmated; Without loud moves the position is already quiet
+	if (moves.Size() == 0)
+		return inCheck ? (aiTurn ? -1000 : 1000) : standPat;
+
+	int scores[MoveList::capacity];
+	ScoreMoves(nextGame, moves, scores, Move(), ply);
+
+	int bestValue = evading ? (aiTurn ? INT32_MIN : INT32_MAX) : standPat;
+
+	for (int i = 0; i < moves.Size(); i++)
+	{
+		Move move = PickMove(moves, scores, i);
+
+		// Only captures and promotions make the position loud, unless every escape from check is searched
+		if (!evading && !move.IsCapture() && !move.IsPromotion())
+			continue;
+
+		// Value of the piece taken, if any
+		int victim = move.IsEnPassant() ? 1 : abs(nextGame.gameBoard[move.Final() % 8][move.Final() / 8]);
+
+		// Delta pruning; Skip captures too small to reach the window before making them, unless they give check and so swing the fitness
+		if (!evading && !move.IsPromotion()
+			&& (aiTurn ? standPat + deltaValues[victim] + deltaMargin <= alpha : standPat - deltaValues[victim] - deltaMargin >= beta)
+			&& !nextGame.GivesCheck(move))
+			continue;
+
+		UndoRecord undo;
+		nextGame.DoMove(move, undo);
+
+		int newValue = quiescenceSearch(nextGame, alpha, beta, ply + 1);
+		nextGame.UndoMove(move, undo);
+
+		// Results of a search cut short are never used
+		if (Aborted())
+			return 0;
+
+		if (aiTurn ? newValue > bestValue : newValue < bestValue)
+			bestValue = newValue;
+
+		if (aiTurn && bestValue > alpha)
+			alpha = bestValue;
+		if (!aiTurn && bestValue < beta)
+			beta = bestValue;
+
+		if (beta <= alpha)
+			break;
+	}
+
+	return bestValue;
+}
+
+// Ranks a board for the AI, reusing the score of an earlier visit to the same position
+// Returns an integer representing it's fitness
+int DekuBot::StaticEvaluation(const GameBoard& game)
+{
+	// The fifty move rule is not part of the key, so a board it draws is scored without the cache
+	if (game.numMovesSinceCapture() >= fiftyMoveLimit)
+		return game.RankBoard(aiColor, &pawnTable);
+
+	int score;
+	if (!evalCache.Probe(game.positionKey(), score))
+	{
+		score = game.RankBoard(aiColor, &pawnTable);
+		evalCache.Store(game.positionKey(), score);
+	}
+
+	return score;
+}
+
+// Stores the result of searching a position in the transposition table
+// Results cut short by the search time or by a cutoff of a split point are not trusted and are left out
+void DekuBot::StoreResult(const GameBoard& game, const Move bestMove, const int score, const int depth, const int alpha, const int beta)
+{
+	if (Aborted())
+		return;
+
+	// A score outside the window only bounds the true score
+	Bound bound = ExactBound;
+	if (score <= alpha)
+		bound = UpperBound;
+	else if (score >= beta)
+		bound = LowerBound;
+
+	table.Store(game.positionKey(), bestMove, score, depth, bound);
+}
+
+// Scores every move of a list for move ordering
+// Hash move -> Captures and promotions by most valuable victim, then least valuable attacker -> Killer moves -> Quiet moves by history
+void DekuBot::ScoreMoves(const GameBoard& game, const MoveList& moves, int scores[], const Move hashMove, const int ply) const
+{
+	int side = game.whosTurn() ? 0 : 1;
+
+	for (int i = 0; i < moves.Size(); i++)
+	{
+		Move move = moves[i];
+		int initial = move.Initial();
+		int final = move.Final();
+
+		if (move == hashMove)
+			scores[i] = hashMoveScore;
+		else if (move.IsCapture() || move.IsPromotion())
 		{
-			GameBoard copy = nextGame;
-			copy.MovePiece(move.first, move.second);
+			int victim = move.IsEnPassant() ? 1 : orderValues[abs(game.gameBoard[final % 8][final / 8])];
+			int attacker = orderValues[abs(game.gameBoard[initial % 8][initial / 8])];
 
-			int newValue = miniMaxMove(copy, alpha, beta, currentDepth - 1, endTime);
+			scores[i] = captureScore + 100 * victim - attacker;
+			if (move.IsPromotion())
+				scores[i] += 100 * promotionValues[move.PromotionPiece()];
+		}
+		else if (ply < maxPly && move == killers[ply][0])
+			scores[i] = killerScore + 1;
+		else if (ply < maxPly && move == killers[ply][1])
+			scores[i] = killerScore;
+		else
+			scores[i] = history[side][initial][final];
+	}
+}
 
-			if (newValue < minValue)
-				minValue = newValue;
+// Moves the best scored move not yet searched to a given index of the list
+// Returns that move
+Move DekuBot::PickMove(MoveList& moves, int scores[], const int index)
+{
+	int best = index;
+	for (int i = index + 1; i < moves.Size(); i++)
+		if (scores[i] > scores[best])
+			best = i;
 
-			if (minValue < beta)
-				beta = minValue;
+	std::swap(moves[index], moves[best]);
+	std::swap(scores[index], scores[best]);
+	return moves[index];
+}
 
-			if (beta <= alpha)
-				break;
+// Remembers a move that cut the search short so it is tried early in similar positions
+// Quiet moves become killers for their ply and gain history; Captures are already ordered well
+void DekuBot::RecordCutoff(const GameBoard& game, const Move move, const int index, const int depth, const int ply)
+{
+	cutoffs++;
+	if (index == 0)
+		firstMoveCutoffs++;
+
+	if (move.IsCapture() || move.IsPromotion())
+		return;
+
+	// Keep the two most recent killers of this ply
+	if (ply < maxPly && move != killers[ply][0])
+	{
+		killers[ply][1] = killers[ply][0];
+		killers[ply][0] = move;
+	}
+
+	// Deeper cutoffs save more work, so they count for more
+	int& score = history[game.whosTurn() ? 0 : 1][move.Initial()][move.Final()];
+	score += depth * depth;
+
+	// Keep every history score below the killers
+	if (score >= killerScore)
+		for (int side = 0; side < 2; side++)
+			for (int from = 0; from < 64; from++)
+				for (int to = 0; to < 64; to++)
+					history[side][from][to] /= 2;
+}
+
+// Counts a searched node, reading the clock only once every few thousand nodes
+// Returns true once the search should stop
+bool DekuBot::ShouldStop()
+{
+	if ((++nodes & (pollInterval - 1)) == 0 && std::chrono::steady_clock::now() >= deadline)
+		stopFlag.store(true, std::memory_order_relaxed);
+
+	return Aborted();
+}
+
+// Checks if a position is drawn by the fifty move rule or by repetition
+// A position met earlier on the line searched repeats once, while one from before the root must have been played twice
+bool DekuBot::IsDraw(const GameBoard& game, const int ply) const
+{
+	int reversible = game.numMovesSinceCapture();
+	if (reversible >= fiftyMoveLimit)
+		return true;
+
+	// Positions before the root, with the root itself last
+	const std::vector<std::uint64_t>& played = master->gameKeys;
+	int playedBefore = 0;
+
+	// Only positions with the same player to move, and no capture or pawn move since, can be the same
+	for (int back = 2; back <= reversible; back += 2)
+	{
+		int earlier = ply - back;
+
+		// Passing the turn does not reach a position by real moves, so nothing before a null move counts
+		if (earlier + 1 >= 0 && (nullMoveMade[earlier + 1] || (earlier >= 0 && nullMoveMade[earlier])))
+			return false;
+
+		std::uint64_t key;
+		if (earlier >= 0)
+			key = positionKeys[earlier];
+		else if ((int)played.size() - 1 + earlier >= 0)
+			key = played[played.size() - 1 + earlier];
+		else
+			return false;
+
+		if (key == game.positionKey())
+		{
+			if (earlier > 0 || ++playedBefore == 2)
+				return true;
 		}
+	}
+
+	return false;
+}
+
+// Checks if the search has to stop, or a split point this thread works under was cut off
+// Either way the result of the current node is thrown away
+bool DekuBot::Aborted() const
+{
+	if (stopFlag.load(std::memory_order_relaxed))
+		return true;
 
-		return minValue;
+	for (const SplitPoint* split = activeSplit; split; split = split->parent)
+		if (split->cutoff.load(std::memory_order_relaxed))
+			return true;
+
+	return false;
+}
+
+// Forgets the killer moves of the last position and halves the history
+void DekuBot::AgeMoveOrdering()
+{
+	// Killer moves belong to the last position, while older history only counts for half
+	for (int ply = 0; ply < maxPly; ply++)
+		killers[ply][0] = killers[ply][1] = Move();
+
+	for (int side = 0; side < 2; side++)
+		for (int from = 0; from < 64; from++)
+			for (int to = 0; to < 64; to++)
+				history[side][from][to] /= 2;
+
+	cutoffs = firstMoveCutoffs = 0;
+}
+
+// Checks if the current node may be shared between threads
+bool DekuBot::CanSplit(const int currentDepth) const
+{
+	return currentDepth >= minSplitDepth && !splits.Full() && master->idleWorkers.load(std::memory_order_relaxed) > 0;
+}
+
+// Checks if a node may pass the turn to prove its score is past the window
+// Never while in check, right after another null move, inside the principal variation, or with only pawns left,
+// where passing could be the best move and the test would lie
+bool DekuBot::CanNullMove(const GameBoard& game, const int alpha, const int beta, const int currentDepth, const int ply, const int staticFitness) const
+{
+	bool aiTurn = aiColor == 1 && game.whosTurn() || aiColor == -1 && !game.whosTurn();
+	bool draw = game.isWhiteInCheck() && game.isBlackInCheck();
+	bool inCheck = !draw && (game.whosTurn() ? game.isWhiteInCheck() : game.isBlackInCheck());
+
+	return currentDepth >= 3 && !inCheck && !draw && isNullWindow(alpha, beta) && !(ply > 0 && nullMoveMade[ply - 1])
+		&& game.hasNonPawnPieces(game.whosTurn() ? 1 : -1)
+		&& (aiTurn ? staticFitness >= beta : staticFitness <= alpha);
+}
+
+// Young Brothers Wait; Shares the moves of a node left after its eldest brother between this thread and idle threads
+// Updates the window, best score, best move and line of the node with everything found
+void DekuBot::SplitNode(GameBoard& nextGame, MoveList& moves, int scores[], const int index, int& alpha, int& beta, int& bestValue, Move& bestMove, const int currentDepth, const int ply, const bool aiTurn, const bool inCheck)
+{
+	SplitPoint split(nextGame, activeSplit, moves, scores, index);
+	split.depth = currentDepth;
+	split.ply = ply;
+	split.aiTurn = aiTurn;
+	split.inCheck = inCheck;
+	for (int line = 0; line <= ply; line++)
+		split.lineKeys[line] = positionKeys[line];
+	for (int line = 0; line < ply; line++)
+		split.lineNullMoves[line] = nullMoveMade[line];
+	split.alpha = alpha;
+	split.beta = beta;
+	split.bestValue = bestValue;
+	split.bestMove = bestMove;
+	for (int next = ply; next < pvLength[ply]; next++)
+		split.line.Add(pvTable[ply][next]);
+
+	// Offer the node to idle threads, then search it alongside them
+	splits.Push(&split);
+	activeSplit = &split;
+	SearchSplitPoint(nextGame, split);
+	splits.Pop();
+
+	// The split point lives on this thread's stack, so it can not be left while helpers still search it
+	// Rather than sit idle, help search nodes the helpers have split below it
+	while (split.workers.load() > 0)
+	{
+		SplitPoint* work = StealWork(&split);
+		if (work)
+			JoinSplitPoint(*work);
+		else
+			std::this_thread::yield();
+	}
+
+	activeSplit = split.parent;
+
+	// Every helper has left, so the results can be read without the lock
+	alpha = split.alpha;
+	beta = split.beta;
+	bestValue = split.bestValue;
+	bestMove = split.bestMove;
+
+	for (int next = 0; next < split.line.Size(); next++)
+		pvTable[ply][ply + next] = split.line[next];
+	pvLength[ply] = ply + split.line.Size();
+}
+
+// Searches moves of a split point until none are left or the node is cut off
+void DekuBot::SearchSplitPoint(GameBoard& board, SplitPoint& split)
+{
+	while (true)
+	{
+		// Take the best ordered move left, along with the latest window
+		Move move;
+		int index, score, alpha, beta;
+		{
+			std::lock_guard<std::mutex> guard(split.lock);
+			if (split.cutoff || split.nextIndex >= split.moves.Size())
+				return;
+
+			index = split.nextIndex++;
+			move = PickMove(split.moves, split.scores, index);
+			score = split.scores[index];
+			alpha = split.alpha;
+			beta = split.beta;
+		}
+
+		int newValue = searchMove(board, move, index, score, alpha, beta, split.depth, split.ply, split.aiTurn, split.inCheck);
+
+		// Results of a search cut short are never used
+		if (Aborted())
+			return;
+
+		std::lock_guard<std::mutex> guard(split.lock);
+
+		if (split.aiTurn ? newValue > split.bestValue : newValue < split.bestValue)
+		{
+			split.bestValue = newValue;
+			split.bestMove = move;
+
+			UpdatePrincipalVariation(split.ply, move);
+			split.line.Clear();
+			for (int next = split.ply; next < pvLength[split.ply]; next++)
+				split.line.Add(pvTable[split.ply][next]);
+		}
+
+		if (split.aiTurn && split.bestValue > split.alpha)
+			split.alpha = split.bestValue;
+		if (!split.aiTurn && split.bestValue < split.beta)
+			split.beta = split.bestValue;
+
+		// Tell every thread still searching the node to stop
+		if (split.beta <= split.alpha && !split.cutoff)
+		{
+			split.cutoff = true;
+			RecordCutoff(board, move, index, split.depth, split.ply);
+			return;
+		}
+	}
+}
+
+// Searches a split point this thread has joined on a copy of its board, then leaves it
+void DekuBot::JoinSplitPoint(SplitPoint& split)
+{
+	const SplitPoint* outer = activeSplit;
+	activeSplit = &split;
+
+	// Take on the line leading to the node, so repetitions of positions above it are still found
+	for (int ply = 0; ply <= split.ply; ply++)
+		positionKeys[ply] = split.lineKeys[ply];
+	for (int ply = 0; ply < split.ply; ply++)
+		nullMoveMade[ply] = split.lineNullMoves[ply];
+
+	// The node's moves are real moves, so the first reply may try a null move
+	GameBoard board = split.board;
+	nullMoveMade[split.ply] = false;
+	SearchSplitPoint(board, split);
+
+	activeSplit = outer;
+	split.workers--;
+}
+
+// Loop of a helper thread while splitting nodes; Joins split points of other threads until the search stops
+void DekuBot::WaitForWork()
+{
+	nodes = 0;
+	AgeMoveOrdering();
+
+	while (!stopFlag.load(std::memory_order_relaxed))
+	{
+		SplitPoint* work = StealWork(nullptr);
+		if (work)
+		{
+			master->idleWorkers--;
+			JoinSplitPoint(*work);
+			master->idleWorkers++;
+		}
+		else
+			std::this_thread::yield();
+	}
+}
+
+// Joins a split point of another thread; Only one below an ancestor if one is given
+// Returns the split point, or null if none had work left
+SplitPoint* DekuBot::StealWork(const SplitPoint* ancestor)
+{
+	// Start after this thread, so helpers spread over the owners instead of all crowding the first
+	int team = (int)master->helpers.size() + 1;
+	for (int offset = 1; offset < team; offset++)
+	{
+		int index = (threadIndex + offset) % team;
+		DekuBot* owner = (index == 0) ? master : master->helpers[index - 1].get();
+
+		SplitPoint* split = owner->splits.Steal(ancestor);
+		if (split)
+			return split;
+	}
+
+	return nullptr;
+}
+
+// Puts a move in front of the line its child found, making it the line of a given ply
+void DekuBot::UpdatePrincipalVariation(const int ply, const Move move)
+{
+	int childLength = (ply + 1 < maxPly) ? pvLength[ply + 1] : ply + 1;
+
+	pvTable[ply][ply] = move;
+	for (int next = ply + 1; next < childLength; next++)
+		pvTable[ply][next] = pvTable[ply + 1][next];
+
+	pvLength[ply] = childLength;
+}
+
+// Prints the depth, score, nodes, time and principal variation of a finished depth
+void DekuBot::PrintPrincipalVariation(const int depth, const int score) const
+{
+	auto elapsed = std::chrono::steady_clock::now() - (deadline - std::chrono::milliseconds(maxSearchTime));
+	long long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+
+	std::cout << "Depth " << depth << " | Score " << score << " | Nodes " << nodes << " | Time " << milliseconds << "ms | PV";
+	for (int ply = 0; ply < pvLength[0]; ply++)
+		std::cout << " " << pvTable[0][ply].Notation();
+	std::cout << std::endl;
+}
+
+// Sorts the root moves for the next depth; The last best move first, then by score, then by subtree size
+// Scores and node counts are sorted along with their moves
+void DekuBot::OrderRootMoves(MoveList& moves, int scores[], long long nodeCounts[], const Move bestMove)
+{
+	// Insertion sort; Root lists are short and mostly sorted after the first depth
+	for (int i = 1; i < moves.Size(); i++)
+	{
+		Move move = moves[i];
+		int score = scores[i];
+		long long count = nodeCounts[i];
+
+		int j = i;
+		while (j > 0 && RootMoveBefore(move, score, count, moves[j - 1], scores[j - 1], nodeCounts[j - 1], bestMove))
+		{
+			moves[j] = moves[j - 1];
+			scores[j] = scores[j - 1];
+			nodeCounts[j] = nodeCounts[j - 1];
+			j--;
+		}
+
+		moves[j] = move;
+		scores[j] = score;
+		nodeCounts[j] = count;
 	}
+}
+
+// Checks if one root move should be searched before another
+bool DekuBot::RootMoveBefore(const Move move, const int score, const long long count, const Move other, const int otherScore, const long long otherCount, const Move bestMove)
+{
+	if (move == bestMove || other == bestMove)
+		return move == bestMove;
+
+	if (score != otherScore)
+		return score > otherScore;
+
+	return count > otherCount;
 }
\ No newline at end of file
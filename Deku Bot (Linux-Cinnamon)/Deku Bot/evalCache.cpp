@@ -0,0 +1,6 @@
+#include "EvalCache.hpp"
+
+// Default Constructor; Every slot starts out empty
+EvalCache::EvalCache() : entries(new Entry[size]())
+{
+}
\ No newline at end of file
@@ -1,4 +1,133 @@
 #include "GameBoard.hpp"
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+// Piece type of each value in the key
+static const int pieceTypes[10] = { -1, Pawn, Pawn, Rook, Rook, Knight, Bishop, Queen, King, King };
+
+// Value in the key of each piece type, ignoring castling and en passant
+static const piece pieceValues[6] = { 1, 3, 5, 6, 7, 8 };
+
+// Castling rights kept when a piece moves from or to each tile
+// Moving a king or rook from its starting tile, or taking a rook there, loses the matching rights
+static const int castleMasks[64] = {
+	~BlackLong, ~0, ~0, ~0, ~(BlackShort | BlackLong), ~0, ~0, ~BlackShort,
+	~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+	~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+	~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+	~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+	~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+	~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+	~WhiteLong, ~0, ~0, ~0, ~(WhiteShort | WhiteLong), ~0, ~0, ~WhiteShort
+};
+
+// Random keys of the Zobrist hash
+// One per piece type on each tile for each side, one for black to move, one per set of castling rights and one per en passant file
+static std::uint64_t pieceKeys[2][6][64], turnKey, castlingKeys[16], enPassantKeys[8];
+
+// Fills the keys once at program start; Fixed seed so a position has the same key on every run
+static bool buildKeys()
+{
+	std::uint64_t seed = 0x2545F4914F6CDD1DULL;
+
+	// Xorshift generator
+	auto random = [&seed]()
+	{
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		return seed * 2685821657736338717ULL;
+	};
+
+	for (int side = 0; side < 2; side++)
+		for (int type = Pawn; type <= King; type++)
+			for (int square = 0; square < 64; square++)
+				pieceKeys[side][type][square] = random();
+
+	turnKey = random();
+
+	for (int rights = 0; rights < 16; rights++)
+		castlingKeys[rights] = random();
+
+	for (int x = 0; x < 8; x++)
+		enPassantKeys[x] = random();
+
+	return true;
+}
+
+static const bool keysBuilt = buildKeys();
+
+// Fitness each piece type adds to white on each tile for each side, in the midgame and in the endgame; Black pieces hold negative values
+// Counts material and every tile a knight or king reaches, none of which depend on the other pieces
+// Pawns are left to the pawn structure, which is scored on its own
+static int pieceSquareValues[2][2][6][64];
+
+// Weight of each piece type in the game phase; Pawns and kings never leave the endgame
+static const int phaseWeights[6] = { 0, 2, 1, 1, 4, 0 };
+
+// Weights of the terms scored from the pieces around each piece, in quarter points for the midgame and for the endgame
+// The endgame weights are the ones the terms had before they were blended, so boards with only kings and pawns score the same
+
+// Checks are easier to meet while pieces are left to block them
+static const int checkWeights[2] = { 1600, 2000 };
+
+// Pawns guarding and attacking pieces hold the board together while it is full
+static const int pawnTargetWeights[2] = { 6, 4 };
+
+// The right to castle only matters while there is an attack to hide from
+static const int castleRookWeights[2] = { 8, 4 };
+
+// Knights need pieces around them to jump between
+static const int knightTargetWeights[2] = { 6, 4 };
+
+// Tiles each piece type reaches; Sliders gain as the board opens up, and a queen out early is only chased around
+static const int mobilityWeights[6][2] = { { 0, 0 }, { 3, 5 }, { 0, 0 }, { 4, 5 }, { 2, 5 }, { 0, 0 } };
+
+// Fills the piece square values once at program start
+// Uses shifts instead of the attack tables, which may not be filled yet
+static bool buildPieceSquareValues()
+{
+	for (int square = 0; square < 64; square++)
+	{
+		bitboard tile = squareMask(square);
+
+		bitboard vertical = shiftUp(shiftUp(tile)) | shiftDown(shiftDown(tile));
+		bitboard horizontal = shiftLeft(shiftLeft(tile)) | shiftRight(shiftRight(tile));
+		int knightTiles = popCount(shiftLeft(vertical) | shiftRight(vertical) | shiftUp(horizontal) | shiftDown(horizontal));
+
+		bitboard row = tile | shiftLeft(tile) | shiftRight(tile);
+		int kingTiles = popCount((row | shiftUp(row) | shiftDown(row)) & ~tile);
+
+		for (int side = 0; side < 2; side++)
+		{
+			int sign = (side == 0) ? 1 : -1;
+
+			// Knights are worth less once the board empties, while long range pieces are worth more
+			pieceSquareValues[Midgame][side][Rook][square] = sign * 3;
+			pieceSquareValues[Midgame][side][Knight][square] = sign * (5 + knightTiles);
+			pieceSquareValues[Midgame][side][Bishop][square] = sign * 6;
+			pieceSquareValues[Midgame][side][Queen][square] = sign * 7;
+
+			pieceSquareValues[Endgame][side][Rook][square] = sign * 4;
+			pieceSquareValues[Endgame][side][Knight][square] = sign * (4 + knightTiles);
+			pieceSquareValues[Endgame][side][Bishop][square] = sign * 7;
+			pieceSquareValues[Endgame][side][Queen][square] = sign * 8;
+
+			// While the board is full, kings are safest on the rows behind their pawns
+			int rowsFromHome = (side == 0) ? 7 - square / 8 : square / 8;
+			pieceSquareValues[Midgame][side][King][square] = sign * (20 + 2 * (rowsFromHome < 3 ? 3 - rowsFromHome : 0));
+
+			// Once the pieces are gone, kings score two points for every tile around them
+			pieceSquareValues[Endgame][side][King][square] = sign * (20 + 2 * kingTiles);
+		}
+	}
+
+	return true;
+}
+
+static const bool pieceSquareValuesBuilt = buildPieceSquareValues();
 
 // Default Constructor
 GameBoard::GameBoard()
@@ -8,6 +137,8 @@ GameBoard::GameBoard()
 	blackInCheck = whiteInCheck = false;
 	whiteTurn = true;
 	blackPieces = whitePieces = 16;
+	castlingRights = WhiteShort | WhiteLong | BlackShort | BlackLong;
+	enPassantSquare = -1;
 
 	// Configuration of back ranks
 	piece backRanks[8] = { 4, 5, 6, 7, 9, 6, 5, 4 };
@@ -21,35 +152,153 @@ GameBoard::GameBoard()
 		// Set back ranks for each color
 		gameBoard[x][0] = -backRanks[x];
 		gameBoard[x][7] = backRanks[x];
-
-		// Set the previous position to all 0 tiles
-		for (int y = 0; y < 8; y++)
-			previousPosition[x][y] = 0;
 	}
+
+	// Build the bitboards for the starting position
+	UpdateBitboards();
 }
 
 // Explicit Constructor
 // Takes a reference to a pre-made game board
 GameBoard::GameBoard(const piece(&gameState)[8][8])
 {
+	// Assume a capture was just made
+	movesSinceCapture = 0;
+
+	// Assume that it is white's turn
+	whiteTurn = true;
+
+	// Assume no pawn just moved two tiles
+	enPassantSquare = -1;
+
+	blackPieces = whitePieces = 0;
+
 	// Copy the piece positions to this objects game board
 	for (int x = 0; x < 8; x++)
 		for (int y = 0; y < 8; y++)
 		{
-			gameBoard[x][y] = gameState[x][y];
+			piece value = gameState[x][y];
+			int sign = (value > 0) ? 1 : -1;
+
+			// Check Promotions
+			if ((value == 1 || value == 2) && y == 0)
+				value = 7;
+			if ((value == -1 || value == -2) && y == 7)
+				value = -7;
+
+			// Check Past En Passant Opportunities
+			if (abs(value) == 2)
+				value = sign;
+
+			gameBoard[x][y] = value;
+
+			// Count pieces
+			if (value < 0)
+				blackPieces++;
+			if (value > 0)
+				whitePieces++;
+		}
 
-			// Set the previous position to all 0 tiles
-			previousPosition[x][y] = 0;
+	// A castleable king on its starting tile and a castleable rook in the matching corner keep that right
+	castlingRights = 0;
+	if (gameBoard[4][7] == 9 && gameBoard[7][7] == 4)
+		castlingRights |= WhiteShort;
+	if (gameBoard[4][7] == 9 && gameBoard[0][7] == 4)
+		castlingRights |= WhiteLong;
+	if (gameBoard[4][0] == -9 && gameBoard[7][0] == -4)
+		castlingRights |= BlackShort;
+	if (gameBoard[4][0] == -9 && gameBoard[0][0] == -4)
+		castlingRights |= BlackLong;
+
+	// Any other castleable pieces have lost their right
+	for (int x = 0; x < 8; x++)
+		for (int y = 0; y < 8; y++)
+		{
+			if (abs(gameBoard[x][y]) == 4)
+				gameBoard[x][y] -= (gameBoard[x][y] > 0) ? 1 : -1;
+			if (abs(gameBoard[x][y]) == 9)
+				gameBoard[x][y] -= (gameBoard[x][y] > 0) ? 1 : -1;
 		}
 
-	// Evaluate the game board position
-	EvaluateBoard();
+	UpdateCastleValues();
 
-	// Assume a capture was just made
-	movesSinceCapture = 0;
+	// Build the bitboards and flags for the position
+	UpdateBitboards();
+	UpdateChecks();
+}
 
-	// Assume that it is white's turn
-	whiteTurn = true;
+// FEN Constructor
+// Takes a position in Forsyth-Edwards Notation; Missing fields keep the values of a new game
+GameBoard::GameBoard(const std::string& fen)
+{
+	std::istringstream fields(fen);
+	std::string placement, turn = "w", castling = "-", enPassant = "-";
+	int halfMoves = 0;
+	fields >> placement >> turn >> castling >> enPassant >> halfMoves;
+
+	// Set flags
+	movesSinceCapture = halfMoves;
+	whiteTurn = turn != "b";
+	blackPieces = whitePieces = 0;
+	castlingRights = 0;
+	enPassantSquare = -1;
+
+	// Place pieces row by row from the top of the board; Digits skip empty tiles
+	const std::string letters = "prnbqk";
+	int x = 0, y = 0;
+	for (char symbol : placement)
+	{
+		if (symbol == '/')
+		{
+			x = 0;
+			y++;
+		}
+		else if (symbol >= '1' && symbol <= '8')
+			x += symbol - '0';
+		else if (letters.find(tolower(symbol)) != std::string::npos && InBounds(x, y))
+		{
+			// Upper case letters are white pieces
+			int sign = isupper(symbol) ? 1 : -1;
+			gameBoard[x][y] = sign * pieceValues[letters.find(tolower(symbol))];
+
+			if (sign == 1)
+				whitePieces++;
+			else
+				blackPieces++;
+
+			x++;
+		}
+	}
+
+	// A right to castle needs its king and rook on their starting tiles
+	if (castling.find('K') != std::string::npos && gameBoard[4][7] == 8 && gameBoard[7][7] == 3)
+		castlingRights |= WhiteShort;
+	if (castling.find('Q') != std::string::npos && gameBoard[4][7] == 8 && gameBoard[0][7] == 3)
+		castlingRights |= WhiteLong;
+	if (castling.find('k') != std::string::npos && gameBoard[4][0] == -8 && gameBoard[7][0] == -3)
+		castlingRights |= BlackShort;
+	if (castling.find('q') != std::string::npos && gameBoard[4][0] == -8 && gameBoard[0][0] == -3)
+		castlingRights |= BlackLong;
+
+	UpdateCastleValues();
+
+	// The en passant tile is behind the pawn that just moved two tiles
+	if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && (enPassant[1] == '3' || enPassant[1] == '6'))
+	{
+		int passedX = enPassant[0] - 'a';
+		int passedY = (enPassant[1] == '6') ? 3 : 4;
+		int sign = (passedY == 3) ? -1 : 1;
+
+		if (gameBoard[passedX][passedY] == sign)
+		{
+			gameBoard[passedX][passedY] = sign * 2;
+			enPassantSquare = squareIndex(passedX, '8' - enPassant[1]);
+		}
+	}
+
+	// Build the bitboards and flags for the position
+	UpdateBitboards();
+	UpdateChecks();
 }
 
 // Copy Constructor
@@ -62,16 +311,30 @@ GameBoard::GameBoard(const GameBoard& rhs)
 	whiteTurn = rhs.whiteTurn;
 	blackPieces = rhs.blackPieces;
 	whitePieces = rhs.whitePieces;
+	castlingRights = rhs.castlingRights;
+	enPassantSquare = rhs.enPassantSquare;
+	zobristKey = rhs.zobristKey;
+	pawnZobristKey = rhs.pawnZobristKey;
+	pieceSquareScore[Midgame] = rhs.pieceSquareScore[Midgame];
+	pieceSquareScore[Endgame] = rhs.pieceSquareScore[Endgame];
+	phase = rhs.phase;
 
 	// Copy the board of the other object
 	for (int x = 0; x < 8; x++)
 		for (int y = 0; y < 8; y++)
-		{
 			gameBoard[x][y] = rhs.gameBoard[x][y];
 
-			// Copy the previous position of the rhs
-			previousPosition[x][y] = rhs.previousPosition[x][y];
-		}
+	// Copy the bitboards of the other object
+	for (int side = 0; side < 2; side++)
+	{
+		for (int type = Pawn; type <= King; type++)
+			pieceBoards[side][type] = rhs.pieceBoards[side][type];
+
+		sideBoards[side] = rhs.sideBoards[side];
+		kingSquares[side] = rhs.kingSquares[side];
+	}
+
+	occupiedBoard = rhs.occupiedBoard;
 }
 
 // Performs a move on the board
@@ -79,382 +342,329 @@ GameBoard::GameBoard(const GameBoard& rhs)
 // Returns true if move was made, false otherwise
 bool GameBoard::MovePiece(const coordinates initial, const coordinates final)
 {
-	// Flag holds move validity
-	bool validMove = false;
+	// Ignore tiles outside of the board
+	if (!InBounds(initial.first, initial.second) || !InBounds(final.first, final.second))
+		return false;
 
-	// Calculate all legal moves for the current color's turn
-	std::vector<std::pair<coordinates, coordinates>> legalMoves;
+	int initialSquare = squareIndex(initial.first, initial.second);
+	int finalSquare = squareIndex(final.first, final.second);
 
-	if (whiteTurn)
-		legalMoves = FindMoves(1);
-	else
-		legalMoves = FindMoves(-1);
+	// Calculate all legal moves for the current color's turn
+	MoveList legalMoves;
+	FindMoves(whiteTurn ? 1 : -1, legalMoves);
 
-	// Check to see if the given move exists in the vector of legal moves
+	// Check to see if the given move exists in the list of legal moves
+	// Promotions share their tiles, so prefer the queen if there is a choice
+	Move chosenMove;
 	for (auto& move : legalMoves)
 	{
-		if (move.first != initial)
-			continue;
-
-		if (move.second != final)
+		if (move.Initial() != initialSquare || move.Final() != finalSquare)
 			continue;
 
-		validMove = true;
-		break;
+		if (chosenMove.IsNull() || (move.IsPromotion() && move.PromotionPiece() == Queen))
+			chosenMove = move;
 	}
 
 	// If the move exists, preform the move
-	if (validMove)
+	if (chosenMove.IsNull())
+		return false;
+
+	ApplyMove(chosenMove);
+	return true;
+}
+
+// Makes a move generated by FindMoves for the player whose turn it is, without checking it
+void GameBoard::ApplyMove(const Move move)
+{
+	UndoRecord undo;
+	DoMove(move, undo);
+}
+
+// Makes a move generated by FindMoves for the player whose turn it is, without checking it
+// Fills an undo record that UndoMove uses to take the move back
+void GameBoard::DoMove(const Move move, UndoRecord& undo)
+{
+	int color = whiteTurn ? 1 : -1;
+	int initial = move.Initial();
+	int final = move.Final();
+
+	// En passant takes the pawn beside the moving pawn instead of the final tile
+	int captureSquare = move.IsEnPassant() ? squareIndex(final % 8, initial / 8) : final;
+
+	// Remember what the move is about to change
+	undo.movesSinceCapture = movesSinceCapture;
+	undo.enPassantSquare = enPassantSquare;
+	undo.castlingRights = castlingRights;
+	undo.moved = gameBoard[initial % 8][initial / 8];
+	undo.captured = move.IsCapture() ? gameBoard[captureSquare % 8][captureSquare / 8] : 0;
+	undo.blackInCheck = blackInCheck;
+	undo.whiteInCheck = whiteInCheck;
+	undo.positionKey = zobristKey;
+
+	// Take the captured piece off the board
+	if (undo.captured != 0)
+	{
+		RemovePiece(captureSquare);
+
+		if (whiteTurn)
+			blackPieces--;
+		else
+			whitePieces--;
+	}
+
+	// Past en passant opportunities expire
+	if (enPassantSquare != -1)
+	{
+		int passedPawn = enPassantSquare + (whiteTurn ? 8 : -8);
+		if (abs(gameBoard[passedPawn % 8][passedPawn / 8]) == 2)
+			gameBoard[passedPawn % 8][passedPawn / 8] /= 2;
+
+		zobristKey ^= enPassantKeys[enPassantSquare % 8];
+		enPassantSquare = -1;
+	}
+
+	// Moving a castleable rook or king loses its right to castle
+	piece value = color * pieceValues[pieceTypes[abs(undo.moved)]];
+
+	// A pawn moving two tiles may be taken en passant, and a pawn reaching the back rank is promoted
+	if (move.IsDoublePush())
+	{
+		value = color * 2;
+		enPassantSquare = (initial + final) / 2;
+		zobristKey ^= enPassantKeys[enPassantSquare % 8];
+	}
+	else if (move.IsPromotion())
+		value = color * pieceValues[move.PromotionPiece()];
+
+	RemovePiece(initial);
+	AddPiece(final, value);
+
+	// The rook jumps over the castling king
+	if (move.IsCastle())
+	{
+		int rookInitial = (move.Flags() == Move::CastleShort) ? final + 1 : final - 2;
+		int rookFinal = (move.Flags() == Move::CastleShort) ? final - 1 : final + 1;
+
+		RemovePiece(rookInitial);
+		AddPiece(rookFinal, color * 3);
+	}
+
+	// Update castling rights
+	castlingRights &= castleMasks[initial] & castleMasks[final];
+	if (castlingRights != undo.castlingRights)
+	{
+		zobristKey ^= castlingKeys[undo.castlingRights] ^ castlingKeys[castlingRights];
+		UpdateCastleValues();
+	}
+
+	// Update flags
+	if (undo.captured != 0 || pieceTypes[abs(undo.moved)] == Pawn)
+		movesSinceCapture = 0;
+	else
+		movesSinceCapture++;
+
+	UpdateChecks();
+
+	// Swap Turns
+	whiteTurn = !whiteTurn;
+	zobristKey ^= turnKey;
+
+	// Debug builds make sure the incremental keys and scores never drift from the position
+	assert(zobristKey == ComputeKey());
+	assert(pawnZobristKey == ComputePawnKey());
+	assert(pieceSquareScore[Midgame] == ComputePieceSquareScore(Midgame));
+	assert(pieceSquareScore[Endgame] == ComputePieceSquareScore(Endgame));
+	assert(phase == ComputePhase());
+}
+
+// Takes back the last move made by DoMove
+// Takes the same move and the undo record DoMove filled
+void GameBoard::UndoMove(const Move move, const UndoRecord& undo)
+{
+	// Swap Turns back to the player who moved
+	whiteTurn = !whiteTurn;
+
+	int color = whiteTurn ? 1 : -1;
+	int initial = move.Initial();
+	int final = move.Final();
+
+	// Return the castled rook to its corner
+	if (move.IsCastle())
+	{
+		int rookInitial = (move.Flags() == Move::CastleShort) ? final + 1 : final - 2;
+		int rookFinal = (move.Flags() == Move::CastleShort) ? final - 1 : final + 1;
+
+		RemovePiece(rookFinal);
+		AddPiece(rookInitial, color * 4);
+	}
+
+	// Return the moved piece with its original value
+	RemovePiece(final);
+	AddPiece(initial, undo.moved);
+
+	// Return the captured piece
+	if (undo.captured != 0)
+	{
+		AddPiece(move.IsEnPassant() ? squareIndex(final % 8, initial / 8) : final, undo.captured);
+
+		if (whiteTurn)
+			blackPieces++;
+		else
+			whitePieces++;
+	}
+
+	// Restore past en passant opportunities
+	enPassantSquare = undo.enPassantSquare;
+	if (enPassantSquare != -1)
+	{
+		int passedPawn = enPassantSquare + (whiteTurn ? 8 : -8);
+		if (abs(gameBoard[passedPawn % 8][passedPawn / 8]) == 1)
+			gameBoard[passedPawn % 8][passedPawn / 8] *= 2;
+	}
+
+	// Restore castling rights
+	if (castlingRights != undo.castlingRights)
 	{
-		// Update the previous position
-		for (int x = 0; x < 8; x++)
-			for (int y = 0; y < 8; y++)
-				previousPosition[x][y] = gameBoard[x][y];
+		castlingRights = undo.castlingRights;
+		UpdateCastleValues();
+	}
+
+	// Restore flags
+	movesSinceCapture = undo.movesSinceCapture;
+	blackInCheck = undo.blackInCheck;
+	whiteInCheck = undo.whiteInCheck;
+
+	// Pieces put back above already restored their part of the key; The rest comes from the record
+	zobristKey = undo.positionKey;
+	assert(zobristKey == ComputeKey());
+	assert(pawnZobristKey == ComputePawnKey());
+	assert(pieceSquareScore[Midgame] == ComputePieceSquareScore(Midgame));
+	assert(pieceSquareScore[Endgame] == ComputePieceSquareScore(Endgame));
+	assert(phase == ComputePhase());
+}
+
+// Passes the turn to the other player without moving a piece, for null move pruning
+// Only valid when the player to move is not in check; Fills an undo record for UndoNullMove
+void GameBoard::DoNullMove(UndoRecord& undo)
+{
+	// Remember what the move is about to change
+	undo.movesSinceCapture = movesSinceCapture;
+	undo.enPassantSquare = enPassantSquare;
+	undo.castlingRights = castlingRights;
+	undo.moved = undo.captured = 0;
+	undo.blackInCheck = blackInCheck;
+	undo.whiteInCheck = whiteInCheck;
+	undo.positionKey = zobristKey;
+
+	// Past en passant opportunities expire
+	if (enPassantSquare != -1)
+	{
+		int passedPawn = enPassantSquare + (whiteTurn ? 8 : -8);
+		if (abs(gameBoard[passedPawn % 8][passedPawn / 8]) == 2)
+			gameBoard[passedPawn % 8][passedPawn / 8] /= 2;
+
+		zobristKey ^= enPassantKeys[enPassantSquare % 8];
+		enPassantSquare = -1;
+	}
 
-		int oldX = initial.first;
-		int oldY = initial.second;
-		int newX = final.first;
-		int newY = final.second;
+	// Swap Turns; No piece moved, so neither king's check changes
+	whiteTurn = !whiteTurn;
+	zobristKey ^= turnKey;
 
-		gameBoard[newX][newY] = gameBoard[oldX][oldY];
-		gameBoard[oldX][oldY] = 0;
+	assert(zobristKey == ComputeKey());
+}
 
-		// Evaluate the board
-		EvaluateBoard();
+// Takes back the last null move made by DoNullMove
+void GameBoard::UndoNullMove(const UndoRecord& undo)
+{
+	// Swap Turns back to the player who passed
+	whiteTurn = !whiteTurn;
 
-		// Swap Turns
-		whiteTurn = !whiteTurn;
+	// Restore past en passant opportunities
+	enPassantSquare = undo.enPassantSquare;
+	if (enPassantSquare != -1)
+	{
+		int passedPawn = enPassantSquare + (whiteTurn ? 8 : -8);
+		if (abs(gameBoard[passedPawn % 8][passedPawn / 8]) == 1)
+			gameBoard[passedPawn % 8][passedPawn / 8] *= 2;
 	}
 
-	// Return the validity of the move
-	return validMove;
+	zobristKey = undo.positionKey;
+	assert(zobristKey == ComputeKey());
 }
 
 // Ranks the board for a given color
 // 1 -> White | -1 -> Black
 // Returns an integer representing it's fitness
-int GameBoard::RankBoard(const int color) const
+int GameBoard::RankBoard(const int color, PawnTable* pawnTable) const
 {
-	// Fitness of the board
-	int fitness = 0;
-
-	// Flags indicate if kings exist
-	bool blackKing = false, whiteKing = false;
-
 	// First check for draws
 	if (blackInCheck && whiteInCheck)
 			return 0;
 
-	// Next check for checks
-	if (color == 1 && blackInCheck)
-		fitness += 500;
-	if (color == 1 && whiteInCheck)
-		fitness -= 500;
+	// Pawn structure; Taken from the table when one is given, since it rarely changes between nodes
+	PawnEntry scratch;
+	PawnEntry* pawns = &scratch;
+	if (pawnTable)
+		pawns = &pawnTable->Slot(pawnZobristKey);
+	if (!pawnTable || pawns->key != pawnZobristKey)
+		EvaluatePawns(*pawns);
 
-	if (color == -1 && whiteInCheck)
-		fitness += 500;
-	if (color == -1 && blackInCheck)
-		fitness -= 500;
+	// Every term is kept for the midgame and for the endgame in quarter points, for the given color
+	int score[2] = { 0, 0 };
 
-	// Check each grid space
-	for (int x = 0; x < 8; x++)
-		for (int y = 0; y < 8; y++)
-			switch (abs(gameBoard[x][y]))
-			{
-				// Pawns
-				case 1:
-				case 2:
-					// For black pawns
-					if (gameBoard[x][y] < 0)
-					{
-						// Add their progress to fitness
-						if (gameBoard[x][y] * color > 0)
-							fitness += (y - 1);
-						else
-							fitness -= (y - 1);
-
-						// Check diagonals
-						if (InBounds(x + 1, y + 1))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x + 1][y + 1] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x + 1][y + 1] != 0)
-									fitness--;
-								fitness--;
-							}
-						}
-
-						if (InBounds(x - 1, y + 1))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x - 1][y + 1] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x - 1][y + 1] != 0)
-									fitness--;
-								fitness--;
-							}
-						}
-					}
-
-					// For white pawns
-					if (gameBoard[x][y] > 0)
-					{
-						// Add their progress to fitness
-						if (gameBoard[x][y] * color > 0)
-							fitness += (6 - y);
-						else
-							fitness -= (6 - y);
-
-						// Check diagonals
-						if (InBounds(x + 1, y - 1))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x + 1][y - 1] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x + 1][y - 1] != 0)
-									fitness--;
-								fitness--;
-							}
-						}
-
-						if (InBounds(x - 1, y - 1))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x - 1][y - 1] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[x - 1][y - 1] != 0)
-									fitness--;
-								fitness--;
-							}
-						}
-					}
-					break;
-
-				// Rooks
-				case 4:
-					if (gameBoard[x][y] * color > 0)
-						fitness++;
-					else
-						fitness--;
-				case 3:
-					if (gameBoard[x][y] * color > 0)
-						fitness += 3;
-					else
-						fitness -= 3;
-					// Check all four directions
-					for (int i = 0; i < 4; i++)
-					{
-						int directionX[4] = { 0, 1, 0, -1 };
-						int directionY[4] = { 1, 0, -1, 0 };
-						int newX = x + directionX[i];
-						int newY = y + directionY[i];
-						while (InBounds(newX, newY))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[newX][newY] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[newX][newY] != 0)
-									fitness--;
-								fitness--;
-							}
-
-							if (gameBoard[newX][newY] != 0)
-								break;
-
-							newX += directionX[i];
-							newY += directionY[i];
-						}
-					}
-					break;
-
-				// Knights
-				case 5:
-
-					if (gameBoard[x][y] * color > 0)
-						fitness += 5;
-					else
-						fitness -= 5;
-
-					for (int areaX = -2; areaX <= 2; areaX++)
-						for (int areaY = -2; areaY <= 2; areaY++)
-						{
-							int distance = abs(areaX) + abs(areaY);
-							if (distance == 3)
-							{
-								int newX = x + areaX;
-								int newY = y + areaY;
-								if (InBounds(newX, newY))
-								{
-									if (gameBoard[x][y] * color > 0)
-									{
-										// Award Extra Fitness if piece is targeting another
-										if (gameBoard[newX][newY] != 0)
-											fitness++;
-										fitness++;
-									}
-									else
-									{
-										// Award Extra Fitness if piece is targeting another
-										if (gameBoard[newX][newY] != 0)
-											fitness--;
-										fitness--;
-									}
-								}
-							}
-						}
-					break;
-
-				// Bishops
-				case 6:
-					if (gameBoard[x][y] * color > 0)
-						fitness += 6;
-					else
-						fitness -= 6;
-
-					// Check all four directions
-					for (int i = 0; i < 4; i++)
-					{
-						int directionX[4] = { 1, 1, -1, -1 };
-						int directionY[4] = { 1, -1, 1, -1 };
-						int newX = x + directionX[i];
-						int newY = y + directionY[i];
-						while (InBounds(newX, newY))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[newX][newY] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[newX][newY] != 0)
-									fitness--;
-								fitness--;
-							}
-
-							if (gameBoard[newX][newY] != 0)
-								break;
-
-							newX += directionX[i];
-							newY += directionY[i];
-						}
-					}
-					break;
-
-				// Queens
-				case 7:
-					if (gameBoard[x][y] * color > 0)
-						fitness += 7;
-					else
-						fitness -= 7;
-
-					// Check all eight directions
-					for (int i = 0; i < 8; i++)
-					{
-						int directionX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
-						int directionY[8] = { 1, 0, -1, 0, 1, -1, 1, -1 };
-						int newX = x + directionX[i];
-						int newY = y + directionY[i];
-						while (InBounds(newX, newY))
-						{
-							if (gameBoard[x][y] * color > 0)
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[newX][newY] != 0)
-									fitness++;
-								fitness++;
-							}
-							else
-							{
-								// Award Extra Fitness if piece is targeting another
-								if (gameBoard[newX][newY] != 0)
-									fitness--;
-								fitness--;
-							}
-
-							if (gameBoard[newX][newY] != 0)
-								break;
-
-							newX += directionX[i];
-							newY += directionY[i];
-						}
-					}
-					break;
-
-				// Kings
-				case 9:
-				case 8:
-					if (gameBoard[x][y] * color > 0)
-						fitness += 20;
-					else
-						fitness -= 20;
-
-					// Check standard moves
-					for (int areaX = -1; areaX <= 1; areaX++)
-						for (int areaY = -1; areaY <= 1; areaY++)
-							if (InBounds(x + areaX, y + areaY) && (areaX != 0 || areaY != 0))
-							{
-								if (gameBoard[x][y] * color > 0)
-								{
-									if (gameBoard[x][y] != 0)
-										fitness++;
-									fitness++;
-								}
-								else
-								{
-									if (gameBoard[x][y] != 0)
-										fitness--;
-									fitness--;
-								}
-							}
-
-					// Flag kings existance
-					if (!whiteKing && gameBoard[x][y] > 0)
-						whiteKing = true;
-					if (!blackKing && gameBoard[x][y] < 0)
-						blackKing = true;
-					break;
-			}
+	// Adds a term counted some number of times with its midgame and endgame weights
+	auto addTerm = [&score](const int count, const int (&weights)[2])
+	{
+		score[Midgame] += count * weights[Midgame];
+		score[Endgame] += count * weights[Endgame];
+	};
 
+	// Material, the tiles knights and kings reach and the pawn structure are kept for white in whole points by every move
+	int perspective = (color == 1) ? 4 : -4;
+	score[Midgame] += perspective * (pieceSquareScore[Midgame] + pawns->score[Midgame]);
+	score[Endgame] += perspective * (pieceSquareScore[Endgame] + pawns->score[Endgame]);
+
+	// Score what depends on the pieces around each piece
+	for (int side = 0; side < 2; side++)
+	{
+		// Pieces of the given color add to fitness, enemy pieces subtract from it
+		int sign = (side == SideIndex(color)) ? 1 : -1;
+
+		// Being in check
+		if ((side == 0) ? whiteInCheck : blackInCheck)
+			addTerm(-sign, checkWeights);
+
+		// Pawns; Extra point for each occupied diagonal
+		addTerm(sign * (popCount(pawns->attacks[side][0] & occupiedBoard) + popCount(pawns->attacks[side][1] & occupiedBoard)), pawnTargetWeights);
+
+		// Rooks
+		bitboard pieces = pieceBoards[side][Rook];
+		addTerm(sign * popCount(pieces & CastleRooks()), castleRookWeights);
+		while (pieces)
+			addTerm(sign * Mobility(rookAttacks(popLowestSquare(pieces), occupiedBoard)), mobilityWeights[Rook]);
+
+		// Knights; Extra point for each occupied target
+		pieces = pieceBoards[side][Knight];
+		while (pieces)
+			addTerm(sign * popCount(knightAttacks(popLowestSquare(pieces)) & occupiedBoard), knightTargetWeights);
+
+		// Bishops
+		pieces = pieceBoards[side][Bishop];
+		while (pieces)
+			addTerm(sign * Mobility(bishopAttacks(popLowestSquare(pieces), occupiedBoard)), mobilityWeights[Bishop]);
+
+		// Queens
+		pieces = pieceBoards[side][Queen];
+		while (pieces)
+			addTerm(sign * Mobility(queenAttacks(popLowestSquare(pieces), occupiedBoard)), mobilityWeights[Queen]);
+	}
+
+	// Blend the two by how much material is left, back in whole points
+	int fitness = (score[Midgame] * gamePhase() + score[Endgame] * (maxPhase - gamePhase())) / (maxPhase * 4);
+
+	// Flags indicate if kings exist
+	bool blackKing = pieceBoards[1][King] != 0, whiteKing = pieceBoards[0][King] != 0;
 
 	// Check that kings exist
 	if (color == 1 && !blackKing)
@@ -471,151 +681,228 @@ int GameBoard::RankBoard(const int color) const
 	return fitness;
 }
 
-// Evaluates the current board and updates pieces / flags
-void GameBoard::EvaluateBoard()
+// Rebuilds every bitboard and both king tiles from the game board array
+void GameBoard::UpdateBitboards()
 {
-	// Assume King is not in check at start
-	blackInCheck = whiteInCheck = false;
+	// Clear the old bitboards
+	for (int side = 0; side < 2; side++)
+	{
+		for (int type = Pawn; type <= King; type++)
+			pieceBoards[side][type] = 0;
 
-	// Flag for pawn movement
-	bool pawnMove = false;
-	// Holds coordinates of kings
-	int blackKingX = -1, blackKingY = -1, whiteKingX = -1, whiteKingY = -1;
-	// Holds number of pieces on the board
-	int currentBlackPieces = 0, currentWhitePieces = 0;
+		sideBoards[side] = 0;
+		kingSquares[side] = -1;
+	}
+
+	occupiedBoard = 0;
+	pawnZobristKey = 0;
+	pieceSquareScore[Midgame] = pieceSquareScore[Endgame] = 0;
+	phase = 0;
 
-	// Check state of the board
+	// Place each piece on its bitboards
 	for (int x = 0; x < 8; x++)
-	{
-		// Check Past En Passant Opportunities
-		if (gameBoard[x][3] == -2)
-		{
-			if (gameBoard[x][2] == 1)
-				gameBoard[x][3] = 0;
-			else
-				gameBoard[x][3] = -1;
-		}
+		for (int y = 0; y < 8; y++)
+			if (gameBoard[x][y] != 0)
+				AddPiece(squareIndex(x, y), gameBoard[x][y]);
 
-		if (gameBoard[x][4] == 2)
-		{
-			if (gameBoard[x][5] == -1)
-				gameBoard[x][4] = 0;
-			else
-				gameBoard[x][4] = 1;
-		}
+	// Start the incremental key from the full position
+	zobristKey = ComputeKey();
+}
+
+// Builds the Zobrist key of the position from scratch
+// Returns the key the incremental updates should match
+std::uint64_t GameBoard::ComputeKey() const
+{
+	std::uint64_t key = castlingKeys[castlingRights];
 
-		// Check New En Passant Opportunities
-		if (gameBoard[x][4] == 1)
-			if (previousPosition[x][6] == 1)
-			{
-				gameBoard[x][4] = 2;
-				pawnMove = true;
-			}
-
-		if (gameBoard[x][3] == -1)
-			if (previousPosition[x][1] == -1)
-			{
-				gameBoard[x][3] = -2;
-				pawnMove = true;
-			}
-
-		// Check Promotions
-		if (gameBoard[x][7] == -1)
+	// Every piece on its tile
+	for (int side = 0; side < 2; side++)
+		for (int type = Pawn; type <= King; type++)
 		{
-			gameBoard[x][7] = -7;
-			pawnMove = true;
+			bitboard pieces = pieceBoards[side][type];
+			while (pieces)
+				key ^= pieceKeys[side][type][popLowestSquare(pieces)];
 		}
 
-		if (gameBoard[x][0] == 1)
+	// Player to move and en passant file
+	if (!whiteTurn)
+		key ^= turnKey;
+	if (enPassantSquare != -1)
+		key ^= enPassantKeys[enPassantSquare % 8];
+
+	return key;
+}
+
+// Builds the Zobrist key of the pawns from scratch
+// Returns the key the incremental updates should match
+std::uint64_t GameBoard::ComputePawnKey() const
+{
+	std::uint64_t key = 0;
+
+	for (int side = 0; side < 2; side++)
+	{
+		bitboard pawns = pieceBoards[side][Pawn];
+		while (pawns)
+			key ^= pieceKeys[side][Pawn][popLowestSquare(pawns)];
+	}
+
+	return key;
+}
+
+// Scores the pawn structure and finds the tiles the pawns attack
+// Fills an entry of the pawn table for the current pawn key
+void GameBoard::EvaluatePawns(PawnEntry& entry) const
+{
+	entry.key = pawnZobristKey;
+	entry.score[Midgame] = entry.score[Endgame] = 0;
+
+	for (int side = 0; side < 2; side++)
+	{
+		int sign = (side == 0) ? 1 : -1;
+		bitboard pawns = pieceBoards[side][Pawn];
+
+		// Pawns attack diagonally forwards
+		bitboard forward = (side == 0) ? shiftUp(pawns) : shiftDown(pawns);
+		entry.attacks[side][0] = shiftLeft(forward);
+		entry.attacks[side][1] = shiftRight(forward);
+
+		// A point for each diagonal a pawn attacks
+		int diagonals = popCount(entry.attacks[side][0]) + popCount(entry.attacks[side][1]);
+		entry.score[Midgame] += sign * diagonals;
+		entry.score[Endgame] += sign * diagonals;
+
+		// Add their progress to fitness; Only half as much while pieces are left to stop them
+		while (pawns)
 		{
-			gameBoard[x][1] = 7;
-			pawnMove = true;
+			int square = popLowestSquare(pawns);
+			int progress = (side == 0) ? 6 - square / 8 : square / 8 - 1;
+			entry.score[Midgame] += sign * (progress / 2);
+			entry.score[Endgame] += sign * progress;
 		}
+	}
+}
 
-		for (int y = 0; y < 8; y++)
+// Adds up the piece square values of every piece from scratch, for the midgame or the endgame
+// Returns the score the incremental updates should match
+int GameBoard::ComputePieceSquareScore(const GamePhase stage) const
+{
+	int score = 0;
+
+	for (int side = 0; side < 2; side++)
+		for (int type = Pawn; type <= King; type++)
 		{
-			// Count black pieces
-			if (gameBoard[x][y] < 0)
-				currentBlackPieces++;
-
-			// Count white pieces
-			if (gameBoard[x][y] > 0)
-				currentWhitePieces++;
-
-			// Check pawn movement
-			if (gameBoard[x][y] == 1 && previousPosition[x][y] == 0)
-				pawnMove = true;
-
-			if (gameBoard[x][y] == -1 && previousPosition[x][y] == 0)
-				pawnMove = true;
-
-			// Check Castle Rooks
-			if (x % 7 != 0 || y % 7 != 0)
-			{
-				if (gameBoard[x][y] == 4)
-					gameBoard[x][y] = 3;
-
-				if (gameBoard[x][y] == -4)
-					gameBoard[x][y] = -3;
-			}
-
-			// Check Kings
-			if (gameBoard[x][y] == 8 || gameBoard[x][y] == 9)
-			{
-				// Record king location
-				whiteKingX = x;
-				whiteKingY = y;
-
-				// Check if king castled
-				if (gameBoard[2][7] == 9)
-				{
-					gameBoard[0][7] = 0;
-					gameBoard[3][7] = 3;
-				}
-				if (gameBoard[6][7] == 9)
-				{
-					gameBoard[7][7] = 0;
-					gameBoard[5][7] = 3;
-				}
-
-				// Check if king moved from start
-				if (gameBoard[x][y] == 9 && (x != 4 || y != 7))
-					gameBoard[x][y] = 8;
-			}
-
-			if (gameBoard[x][y] == -8 || gameBoard[x][y] == -9)
-			{
-				// Record king location
-				blackKingX = x;
-				blackKingY = y;
-
-				// Check if king castled
-				if (gameBoard[2][0] == -9)
-				{
-					gameBoard[0][0] = 0;
-					gameBoard[3][0] = -3;
-				}
-				if (gameBoard[6][0] == -9)
-				{
-					gameBoard[7][0] = 0;
-					gameBoard[5][0] = -3;
-				}
-
-				// Check if king moved from start
-				if (gameBoard[x][y] == -9 && (x != 4 || y != 0))
-					gameBoard[x][y] = -8;
-			}
+			bitboard pieces = pieceBoards[side][type];
+			while (pieces)
+				score += pieceSquareValues[stage][side][type][popLowestSquare(pieces)];
 		}
+
+	return score;
+}
+
+// Adds up the phase weight of every piece from scratch
+// Returns the phase the incremental updates should match
+int GameBoard::ComputePhase() const
+{
+	int total = 0;
+
+	for (int side = 0; side < 2; side++)
+		for (int type = Pawn; type <= King; type++)
+			total += phaseWeights[type] * popCount(pieceBoards[side][type]);
+
+	return total;
+}
+
+// Rewrites the values of kings and corner rooks so the game board shows the castling rights
+void GameBoard::UpdateCastleValues()
+{
+	for (int side = 0; side < 2; side++)
+	{
+		int y = (side == 0) ? 7 : 0;
+		int sign = (side == 0) ? 1 : -1;
+		int shortRight = (side == 0) ? WhiteShort : BlackShort;
+		int longRight = (side == 0) ? WhiteLong : BlackLong;
+
+		// Corner rooks
+		if (gameBoard[7][y] * sign == 3 || gameBoard[7][y] * sign == 4)
+			gameBoard[7][y] = sign * ((castlingRights & shortRight) ? 4 : 3);
+		if (gameBoard[0][y] * sign == 3 || gameBoard[0][y] * sign == 4)
+			gameBoard[0][y] = sign * ((castlingRights & longRight) ? 4 : 3);
+
+		// King on its starting tile
+		if (gameBoard[4][y] * sign == 8 || gameBoard[4][y] * sign == 9)
+			gameBoard[4][y] = sign * ((castlingRights & (shortRight | longRight)) ? 9 : 8);
 	}
+}
 
-	// Update flags
-	if (pawnMove || blackPieces > currentBlackPieces || whitePieces > currentWhitePieces)
-		movesSinceCapture = 0;
-	else
-		movesSinceCapture++;
+// Returns the corner rooks that may still castle
+bitboard GameBoard::CastleRooks() const
+{
+	bitboard rooks = 0;
+
+	if (castlingRights & WhiteShort)
+		rooks |= squareMask(squareIndex(7, 7));
+	if (castlingRights & WhiteLong)
+		rooks |= squareMask(squareIndex(0, 7));
+	if (castlingRights & BlackShort)
+		rooks |= squareMask(squareIndex(7, 0));
+	if (castlingRights & BlackLong)
+		rooks |= squareMask(squareIndex(0, 0));
+
+	return rooks;
+}
 
-	blackPieces = currentBlackPieces;
-	whitePieces = currentWhitePieces;
+// Puts a piece on an empty tile, updating the game board and bitboards
+void GameBoard::AddPiece(const int square, const piece value)
+{
+	int side = SideIndex(value > 0 ? 1 : -1);
+	int type = pieceTypes[abs(value)];
+	bitboard tile = squareMask(square);
+
+	gameBoard[square % 8][square / 8] = value;
+	pieceBoards[side][type] |= tile;
+	sideBoards[side] |= tile;
+	occupiedBoard |= tile;
+	zobristKey ^= pieceKeys[side][type][square];
+	pieceSquareScore[Midgame] += pieceSquareValues[Midgame][side][type][square];
+	pieceSquareScore[Endgame] += pieceSquareValues[Endgame][side][type][square];
+	phase += phaseWeights[type];
+
+	if (type == Pawn)
+		pawnZobristKey ^= pieceKeys[side][Pawn][square];
+
+	if (type == King)
+		kingSquares[side] = square;
+}
+
+// Takes the piece off a tile, updating the game board and bitboards
+void GameBoard::RemovePiece(const int square)
+{
+	piece value = gameBoard[square % 8][square / 8];
+	int side = SideIndex(value > 0 ? 1 : -1);
+	int type = pieceTypes[abs(value)];
+	bitboard tile = squareMask(square);
+
+	gameBoard[square % 8][square / 8] = 0;
+	pieceBoards[side][type] &= ~tile;
+	sideBoards[side] &= ~tile;
+	occupiedBoard &= ~tile;
+	zobristKey ^= pieceKeys[side][type][square];
+	pieceSquareScore[Midgame] -= pieceSquareValues[Midgame][side][type][square];
+	pieceSquareScore[Endgame] -= pieceSquareValues[Endgame][side][type][square];
+	phase -= phaseWeights[type];
+
+	if (type == Pawn)
+		pawnZobristKey ^= pieceKeys[side][Pawn][square];
+
+	if (type == King)
+		kingSquares[side] = -1;
+}
+
+// Updates both check flags after a move
+void GameBoard::UpdateChecks()
+{
+	// Assume King is not in check at start
+	blackInCheck = whiteInCheck = false;
 
 	// Check for draws
 	if (movesSinceCapture == 100)
@@ -625,404 +912,283 @@ void GameBoard::EvaluateBoard()
 	}
 
 	// Check for king existance
-	if (blackKingX == -1 || whiteKingX == -1)
+	if (kingSquares[0] == -1 || kingSquares[1] == -1)
 		return;
 
-	// Check for pawn checks
-	if (gameBoard[blackKingX + 1][blackKingY + 1] == 1 || gameBoard[blackKingX + 1][blackKingY + 1] == 2)
-		blackInCheck = true;
-	if (gameBoard[blackKingX - 1][blackKingY + 1] == 1 || gameBoard[blackKingX - 1][blackKingY + 1] == 2)
-		blackInCheck = true;
+	// Check if either king is attacked
+	blackInCheck = IsAttacked(kingSquares[1], 1);
+	whiteInCheck = IsAttacked(kingSquares[0], -1);
+}
 
-	if (gameBoard[whiteKingX + 1][whiteKingY - 1] == -1 || gameBoard[whiteKingX + 1][whiteKingY - 1] == -2)
-		whiteInCheck = true;
-	if (gameBoard[whiteKingX - 1][whiteKingY - 1] == -1 || gameBoard[whiteKingX - 1][whiteKingY - 1] == -2)
-		whiteInCheck = true;
+// Finds the pieces of a given color (1 for white, -1 for black) that attack a tile, with sliders blocked by a given occupancy
+// Returns a bitboard of the attacking pieces
+bitboard GameBoard::Attackers(const int square, const int color, const bitboard occupied) const
+{
+	// Pieces of the attacking color
+	const bitboard* attackers = pieceBoards[SideIndex(color)];
+
+	// A pawn attacks a tile if an enemy pawn on that tile would attack the pawn
+	return (pawnAttacks(1 - SideIndex(color), square) & attackers[Pawn])
+		| (knightAttacks(square) & attackers[Knight])
+		| (kingAttacks(square) & attackers[King])
+		| (rookAttacks(square, occupied) & (attackers[Rook] | attackers[Queen]))
+		| (bishopAttacks(square, occupied) & (attackers[Bishop] | attackers[Queen]));
+}
 
-	// Check for knight checks
-	for (int areaX = -2; areaX <= 2; areaX++)
-		for (int areaY = -2; areaY <= 2; areaY++)
+// Finds all legal moves for a given color (1 for white, -1 for black)
+// Takes whether to find only captures and promotions, as the quiescence search wants
+// Fills a list of moves in place
+void GameBoard::FindMoves(int color, MoveList& possibleMoves, const bool loudOnly) const
+{
+	// Start from an empty list
+	possibleMoves.Clear();
+
+	int side = SideIndex(color);
+	bitboard friendly = sideBoards[side];
+	bitboard enemy = sideBoards[1 - side];
+	bitboard empty = ~occupiedBoard;
+	const bitboard* enemyPieces = pieceBoards[1 - side];
+	int king = kingSquares[side];
+
+	// Tiles pieces may land on; Only enemy pieces when just the loud moves are wanted
+	bitboard landing = loudOnly ? enemy : ~0ULL;
+
+	// Pieces giving check, pieces pinned to the king, and tiles that answer a check
+	// Boards without a king (only ever set up by hand) leave every move open
+	bitboard checkers = 0, pinned = 0, evasions = ~0ULL;
+	if (king != -1)
+	{
+		checkers = Attackers(king, -color, occupiedBoard);
+
+		// A single check is answered by taking the checker or blocking its ray; A double check only by moving the king
+		if (popCount(checkers) > 1)
+			evasions = 0;
+		else if (checkers)
+			evasions = checkers | betweenSquares(king, lowestSquare(checkers));
+
+		// An enemy slider that sees the king through exactly one friendly piece pins that piece
+		bitboard snipers = (rookAttacks(king, enemy) & (enemyPieces[Rook] | enemyPieces[Queen]))
+			| (bishopAttacks(king, enemy) & (enemyPieces[Bishop] | enemyPieces[Queen]));
+		while (snipers)
 		{
-			int distance = abs(areaX) + abs(areaY);
-			if (distance == 3)
-			{
-				int newX = blackKingX + areaX;
-				int newY = blackKingY + areaY;
-
-				if (InBounds(newX, newY) && gameBoard[newX][newY] == 5)
-				{
-					blackInCheck = true;
-					return;
-				}
-
-				newX = whiteKingX + areaX;
-				newY = whiteKingY + areaY;
-				if (InBounds(newX, newY) && gameBoard[newX][newY] == -5)
-				{
-					whiteInCheck = true;
-					return;
-				}
-			}
+			bitboard blockers = betweenSquares(king, popLowestSquare(snipers)) & occupiedBoard;
+			if (popCount(blockers) == 1)
+				pinned |= blockers & friendly;
 		}
+	}
 
-	// Check for diagonal checks
-	int directionX[4] = { 1, 1, -1, -1 };
-	int directionY[4] = { 1, -1, 1, -1 };
-	for (int i = 0; i < 4; i++)
+	// Returns the tiles a piece may move to without leaving its king in check; Pinned pieces stay on the line of their pin
+	auto legalTargets = [&](const int square)
 	{
-		int newX = blackKingX + directionX[i];
-		int newY = blackKingY + directionY[i];
-		while (InBounds(newX, newY))
-		{
-			// Friendly piece blocks path
-			if (gameBoard[newX][newY] < 0)
-				break;
+		bitboard targets = evasions & ~friendly & landing;
+		if (squareMask(square) & pinned)
+			targets &= lineThrough(king, square);
+		return targets;
+	};
+
+	// Tiles a pawn promotes on when it lands there
+	bitboard backRank = (color == 1) ? rowMask(0) : rowMask(7);
 
-			// Bishop or Queen creates check
-			if (gameBoard[newX][newY] == 6 || gameBoard[newX][newY] == 7)
-				blackInCheck = true;
+	// Tiles a pawn may be pushed to; Only the back rank when just the loud moves are wanted
+	bitboard pushes = loudOnly ? backRank : ~0ULL;
 
-			newX += directionX[i];
-			newY += directionY[i];
+	// Adds a pawn move for every tile of a bitboard, where each move starts a fixed distance away from its final tile
+	auto addPawnMoves = [&](bitboard targets, const int distance, const int flags)
+	{
+		while (targets)
+		{
+			int final = popLowestSquare(targets);
+			int initial = final + distance;
+
+			// Pawns reaching the back rank may become any piece besides a king
+			if (squareMask(final) & backRank)
+				for (int promotion = 0; promotion < 4; promotion++)
+					possibleMoves.Add(Move(initial, final, (flags | Move::Promotion) + promotion));
+			else
+				possibleMoves.Add(Move(initial, final, flags));
 		}
-	}
+	};
 
-	for (int i = 0; i < 4; i++)
+	// Adds the pushes and captures of a group of pawns that land on a set of allowed tiles
+	auto addPawns = [&](const bitboard pawns, const bitboard allowed)
 	{
-		int directionX[4] = { 1, 1, -1, -1 };
-		int directionY[4] = { 1, -1, 1, -1 };
-		int newX = whiteKingX + directionX[i];
-		int newY = whiteKingY + directionY[i];
-		while (InBounds(newX, newY))
+		// For white pawns
+		if (color == 1)
 		{
-			// Friendly piece blocks path
-			if (gameBoard[newX][newY] > 0)
-				break;
 
-			// Bishop or Queen creates check
-			if (gameBoard[newX][newY] == -6 || gameBoard[newX][newY] == -7)
-				whiteInCheck = true;
+			// Check space infront, then two spaces infront from the starting row
+			bitboard forward = shiftUp(pawns) & empty;
+			addPawnMoves(forward & allowed & pushes, 8, Move::Quiet);
+			addPawnMoves(shiftUp(forward & rowMask(5)) & empty & allowed & pushes, 16, Move::DoublePush);
 
-			newX += directionX[i];
-			newY += directionY[i];
+			// Check diagonals
+			addPawnMoves(shiftLeft(shiftUp(pawns)) & enemy & allowed, 9, Move::Capture);
+			addPawnMoves(shiftRight(shiftUp(pawns)) & enemy & allowed, 7, Move::Capture);
 		}
-	}
 
-	// Check for coordinal checks
-	for (int i = 0; i < 4; i++)
-	{
-		int directionX[4] = { 0, 1, 0, -1 };
-		int directionY[4] = { 1, 0, -1, 0 };
-		int newX = blackKingX + directionX[i];
-		int newY = blackKingY + directionY[i];
-		while (InBounds(newX, newY))
+		// For black pawns
+		else
 		{
-			// Friendly piece blocks path
-			if (gameBoard[newX][newY] < 0)
-				break;
 
-			// Rook or Queen creates check
-			if (gameBoard[newX][newY] == 3 || gameBoard[newX][newY] == 4 || gameBoard[newX][newY] == 7)
-				blackInCheck = true;
+			// Check space infront, then two spaces infront from the starting row
+			bitboard forward = shiftDown(pawns) & empty;
+			addPawnMoves(forward & allowed & pushes, -8, Move::Quiet);
+			addPawnMoves(shiftDown(forward & rowMask(2)) & empty & allowed & pushes, -16, Move::DoublePush);
 
-			newX += directionX[i];
-			newY += directionY[i];
+			// Check diagonals
+			addPawnMoves(shiftLeft(shiftDown(pawns)) & enemy & allowed, -7, Move::Capture);
+			addPawnMoves(shiftRight(shiftDown(pawns)) & enemy & allowed, -9, Move::Capture);
 		}
-	}
+	};
 
-	for (int i = 0; i < 4; i++)
+	// Adds a move for every tile of a bitboard, where each move starts on the same tile
+	auto addPieceMoves = [&](const int initial, bitboard targets)
 	{
-		int directionX[4] = { 0, 1, 0, -1 };
-		int directionY[4] = { 1, 0, -1, 0 };
-		int newX = whiteKingX + directionX[i];
-		int newY = whiteKingY + directionY[i];
-		while (InBounds(newX, newY))
+		while (targets)
 		{
-			// Friendly piece blocks path
-			if (gameBoard[newX][newY] > 0)
-				break;
+			int final = popLowestSquare(targets);
+			possibleMoves.Add(Move(initial, final, (squareMask(final) & enemy) ? Move::Capture : Move::Quiet));
+		}
+	};
 
-			// Rook or Queen creates check
-			if (gameBoard[newX][newY] == -3 || gameBoard[newX][newY] == -4 || gameBoard[newX][newY] == -7)
-				whiteInCheck = true;
+	// Pawns; Free pawns move together, pinned pawns one at a time along their pin
+	bitboard pawns = pieceBoards[side][Pawn];
+	addPawns(pawns & ~pinned, evasions);
+	for (bitboard pieces = pawns & pinned; pieces; )
+	{
+		int square = popLowestSquare(pieces);
+		addPawns(squareMask(square), legalTargets(square));
+	}
 
-			newX += directionX[i];
-			newY += directionY[i];
+	// Pawns may only take en passant on the turn right after the enemy pawn moved
+	if (enPassantSquare != -1 && (color == 1) == whiteTurn)
+	{
+		int captured = enPassantSquare + ((color == 1) ? 8 : -8);
+		bitboard pieces = pawnAttacks(1 - side, enPassantSquare) & pawns;
+		while (pieces)
+		{
+			int square = popLowestSquare(pieces);
+
+			// Two pawns leave the same row at once, so test the board after the capture directly
+			bitboard occupied = (occupiedBoard ^ squareMask(square) ^ squareMask(captured)) | squareMask(enPassantSquare);
+			if (king == -1 || !(Attackers(king, -color, occupied) & ~squareMask(captured)))
+				possibleMoves.Add(Move(square, enPassantSquare, Move::EnPassant));
 		}
 	}
+
+	// Rooks
+	bitboard pieces = pieceBoards[side][Rook];
+	while (pieces)
+	{
+		int square = popLowestSquare(pieces);
+		addPieceMoves(square, rookAttacks(square, occupiedBoard) & legalTargets(square));
+	}
+
+	// Knights
+	pieces = pieceBoards[side][Knight];
+	while (pieces)
+	{
+		int square = popLowestSquare(pieces);
+		addPieceMoves(square, knightAttacks(square) & legalTargets(square));
+	}
+
+	// Bishops
+	pieces = pieceBoards[side][Bishop];
+	while (pieces)
+	{
+		int square = popLowestSquare(pieces);
+		addPieceMoves(square, bishopAttacks(square, occupiedBoard) & legalTargets(square));
+	}
+
+	// Queens
+	pieces = pieceBoards[side][Queen];
+	while (pieces)
+	{
+		int square = popLowestSquare(pieces);
+		addPieceMoves(square, queenAttacks(square, occupiedBoard) & legalTargets(square));
+	}
+
+	// King
+	if (king == -1)
+		return;
+
+	// Check standard moves; The king is lifted off the board so it cannot shield a tile behind it from a slider
+	bitboard occupied = occupiedBoard ^ squareMask(king);
+	bitboard targets = kingAttacks(king) & ~friendly & landing, safe = 0;
+	while (targets)
+	{
+		int square = popLowestSquare(targets);
+		if (!Attackers(square, -color, occupied))
+			safe |= squareMask(square);
+	}
+	addPieceMoves(king, safe);
+
+	// Castling requires a right to castle and a king that is not in check; It is never loud
+	int shortRight = (color == 1) ? WhiteShort : BlackShort;
+	int longRight = (color == 1) ? WhiteLong : BlackLong;
+	if (!(castlingRights & (shortRight | longRight)) || checkers || loudOnly)
+		return;
+
+	int y = king / 8;
+
+	// Check castle long; The king may not pass through or land on an attacked tile
+	bitboard between = squareMask(squareIndex(1, y)) | squareMask(squareIndex(2, y)) | squareMask(squareIndex(3, y));
+	if ((castlingRights & longRight) && !(occupiedBoard & between)
+		&& !IsAttacked(squareIndex(3, y), -color) && !IsAttacked(squareIndex(2, y), -color))
+		possibleMoves.Add(Move(king, king - 2, Move::CastleLong));
+
+	// Check castle short
+	between = squareMask(squareIndex(5, y)) | squareMask(squareIndex(6, y));
+	if ((castlingRights & shortRight) && !(occupiedBoard & between)
+		&& !IsAttacked(squareIndex(5, y), -color) && !IsAttacked(squareIndex(6, y), -color))
+		possibleMoves.Add(Move(king, king + 2, Move::CastleShort));
 }
 
-// Finds all possible moves for a given color (1 for white, -1 for black)
-// Returns a vector of pairs of coordinates (pair<int, int>)
-// pair.first -> initial position | pair.second -> final position
-std::vector<std::pair<coordinates, coordinates>> GameBoard::FindMoves(int color) const
+// Checks if a move generated by FindMoves for the player whose turn it is would put the other king in check
+// Answers without making the move
+bool GameBoard::GivesCheck(const Move move) const
 {
-	// Vector of possible moves
-	std::vector<std::pair<coordinates, coordinates>> possibleMoves;
+	int initial = move.Initial(), final = move.Final();
+	int color = (gameBoard[initial % 8][initial / 8] > 0) ? 1 : -1;
+	int side = SideIndex(color);
+	int king = kingSquares[1 - side];
+	if (king == -1)
+		return false;
+
+	// Tiles occupied once the move is made, and the tiles friendly pieces leave
+	bitboard occupied = (occupiedBoard ^ squareMask(initial)) | squareMask(final);
+	bitboard left = squareMask(initial) | squareMask(final);
+	if (move.IsEnPassant())
+		occupied ^= squareMask(final + ((color == 1) ? 8 : -8));
+
+	// The piece standing on the final tile, or the rook beside the king after castling
+	int type = move.IsPromotion() ? move.PromotionPiece() : pieceTypes[abs(gameBoard[initial % 8][initial / 8])];
+	int square = final;
+	if (move.IsCastle())
+	{
+		type = Rook;
+		square = (move.Flags() == Move::CastleShort) ? final - 1 : final + 1;
+		bitboard corner = squareMask((move.Flags() == Move::CastleShort) ? final + 1 : final - 2);
+		occupied ^= squareMask(square) | corner;
+		left |= corner;
+	}
 
-	// Flags for castling
-	bool castleLong = true, castleShort = true;
+	// Direct check from the moved piece
+	bitboard attacks = 0;
+	switch (type)
+	{
+	case Pawn: attacks = pawnAttacks(side, square); break;
+	case Knight: attacks = knightAttacks(square); break;
+	case Bishop: attacks = bishopAttacks(square, occupied); break;
+	case Rook: attacks = rookAttacks(square, occupied); break;
+	case Queen: attacks = queenAttacks(square, occupied); break;
+	default: break;
+	}
+	if (attacks & squareMask(king))
+		return true;
 
-	// Check each grid space
-	for (int x = 0; x < 8; x++)
-		for (int y = 0; y < 8; y++)
-			switch (gameBoard[x][y] * color)
-			{
-				// Pawns
-				case 1:
-					// For black pawns
-					if (color == -1)
-					{
-						// Check for En Passant
-						if (y == 1 && gameBoard[x][2] == 0 && gameBoard[x][3] == 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(x, 3);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-					}
-
-					// For white pawns
-					if (color == 1)
-					{
-						// Check for En Passant
-						if (y == 6 && gameBoard[x][5] == 0 && gameBoard[x][4] == 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(x, 4);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-					}
-				case 2:
-					// For black pawns
-					if (color == -1)
-					{
-						// Check space infront
-						if (InBounds(x, y + 1) && gameBoard[x][y + 1] == 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(x, y + 1);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-
-						// Check diagonals
-						if (InBounds(x + 1, y + 1) && (gameBoard[x + 1][y + 1] > 0 || gameBoard[x + 1][y] == 2))
-						{
-							coordinates initial(x, y);
-							coordinates final(x + 1, y + 1);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-
-						if (InBounds(x - 1, y + 1) && (gameBoard[x - 1][y + 1] > 0 || gameBoard[x - 1][y] == 2))
-						{
-							coordinates initial(x, y);
-							coordinates final(x - 1, y + 1);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-					}
-
-					// For white pawns
-					if (color == 1)
-					{
-						// Check space infront
-						if (InBounds(x, y - 1) && gameBoard[x][y - 1] == 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(x, y - 1);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-
-						// Check diagonals
-						if (InBounds(x + 1, y - 1) && (gameBoard[x + 1][y - 1] < 0 || gameBoard[x + 1][y] == -2))
-						{
-							coordinates initial(x, y);
-							coordinates final(x + 1, y - 1);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-
-						if (InBounds(x - 1, y - 1) && (gameBoard[x - 1][y - 1] < 0 || gameBoard[x - 1][y] == -2))
-						{
-							coordinates initial(x, y);
-							coordinates final(x - 1, y - 1);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-						}
-					}
-					break;
-
-				// Rooks
-				case 3:
-				case 4:
-					// Check all four directions
-					for (int i = 0; i < 4; i++)
-					{
-						int directionX[4] = { 0, 1, 0, -1 };
-						int directionY[4] = { 1, 0, -1, 0 };
-						int newX = x + directionX[i];
-						int newY = y + directionY[i];
-						while (InBounds(newX, newY) && gameBoard[newX][newY] * color <= 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(newX, newY);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-
-							if (gameBoard[newX][newY] * color < 0)
-								break;
-
-							newX += directionX[i];
-							newY += directionY[i];
-						}
-					}
-					break;
-
-				// Knights
-				case 5:
-					for (int areaX = -2; areaX <= 2; areaX++)
-						for (int areaY = -2; areaY <= 2; areaY++)
-						{
-							int distance = abs(areaX) + abs(areaY);
-							if (distance == 3)
-							{
-								int newX = x + areaX;
-								int newY = y + areaY;
-								if (InBounds(newX, newY) && gameBoard[newX][newY] * color <= 0)
-								{
-									coordinates initial(x, y);
-									coordinates final(newX, newY);
-									std::pair<coordinates, coordinates> move(initial, final);
-									possibleMoves.emplace_back(move);
-								}
-							}
-						}
-					break;
-
-				// Bishops
-				case 6:
-					// Check all four directions
-					for (int i = 0; i < 4; i++)
-					{
-						int directionX[4] = { 1, 1, -1, -1 };
-						int directionY[4] = { 1, -1, 1, -1 };
-						int newX = x + directionX[i];
-						int newY = y + directionY[i];
-						while (InBounds(newX, newY) && gameBoard[newX][newY] * color <= 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(newX, newY);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-
-							if (gameBoard[newX][newY] * color < 0)
-								break;
-
-							newX += directionX[i];
-							newY += directionY[i];
-						}
-					}
-					break;
-
-				// Queens
-				case 7:
-					// Check all eight directions
-					for (int i = 0; i < 8; i++)
-					{
-						int directionX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
-						int directionY[8] = { 1, 0, -1, 0, 1, -1, 1, -1 };
-						int newX = x + directionX[i];
-						int newY = y + directionY[i];
-						while (InBounds(newX, newY) && gameBoard[newX][newY] * color <= 0)
-						{
-							coordinates initial(x, y);
-							coordinates final(newX, newY);
-							std::pair<coordinates, coordinates> move(initial, final);
-							possibleMoves.emplace_back(move);
-
-							if (gameBoard[newX][newY] * color < 0)
-								break;
-
-							newX += directionX[i];
-							newY += directionY[i];
-						}
-					}
-					break;
-
-				// Kings
-				case 9:
-					// Check castle long
-					for (int i = 1; i < 4 && castleLong; i++)
-					{
-						// Black King
-						if (color == -1 && !blackInCheck)
-						{
-							if (gameBoard[x - i][y] != 0 || gameBoard[0][y] != -4)
-								castleLong = false;
-						}
-
-						// White King
-						if (color == 1 && !whiteInCheck)
-						{
-							if (gameBoard[x - i][y] != 0 || gameBoard[0][y] != 4)
-								castleLong = false;
-						}
-					}
-
-					// Check castle short
-					for (int i = 1; i < 3 && castleShort; i++)
-					{
-						// Black King
-						if (color == -1 && !blackInCheck)
-						{
-							if (gameBoard[x + i][y] != 0 || gameBoard[7][y] != -4)
-								castleShort = false;
-						}
-
-						// White King
-						if (color == 1 && !whiteInCheck)
-						{
-							if (gameBoard[x + i][y] != 0 || gameBoard[7][y] != 4)
-								castleShort = false;
-						}
-					}
-
-					// Add the castling moves if applicable
-					if (castleLong)
-					{
-						coordinates initial(x, y);
-						coordinates final(x - 2, y);
-						std::pair<coordinates, coordinates> move(initial, final);
-						possibleMoves.emplace_back(move);
-					}
-
-					if (castleShort)
-					{
-						coordinates initial(x, y);
-						coordinates final(x + 2, y);
-						std::pair<coordinates, coordinates> move(initial, final);
-						possibleMoves.emplace_back(move);
-					}
-				case 8:
-					// Check standard moves
-					for (int areaX = -1; areaX <= 1; areaX++)
-						for (int areaY = -1; areaY <= 1; areaY++)
-							if (InBounds(x + areaX, y + areaY) && gameBoard[x + areaX][y + areaY] * color <= 0 && (areaX != 0 || areaY != 0))
-							{
-								coordinates initial(x, y);
-								coordinates final(x + areaX, y + areaY);
-								std::pair<coordinates, coordinates> move(initial, final);
-								possibleMoves.emplace_back(move);
-							}
-					break;
-			}
-
-	// Shring to save space
-	possibleMoves.shrink_to_fit();
-	return possibleMoves;
+	// Discovered check from a slider the move uncovers; Pieces that moved are no longer on their first tile
+	const bitboard* friendly = pieceBoards[side];
+	return ((rookAttacks(king, occupied) & (friendly[Rook] | friendly[Queen]) & ~left)
+		| (bishopAttacks(king, occupied) & (friendly[Bishop] | friendly[Queen]) & ~left)) != 0;
 }
\ No newline at end of file
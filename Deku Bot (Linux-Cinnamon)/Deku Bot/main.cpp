@@ -2,7 +2,10 @@
 #include "DekuBot.hpp"
 #include "Sprite.h"
 #include <SFML/Graphics.hpp> // External Window Library
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <thread>
 
 int main(int argc, char* argv[])
 {
@@ -56,8 +59,8 @@ int main(int argc, char* argv[])
 	// Chess Board
 	GameBoard board;
 
-	// AI
-	DekuBot deku(&board, aiColor);
+	// AI; Searches on every core of the machine
+	DekuBot deku(&board, aiColor, 32, std::thread::hardware_concurrency());
 
 	// Sprite Renderer
 	sprites drawable(board);
@@ -86,16 +89,29 @@ int main(int argc, char* argv[])
 	// Render Window
 	sf::RenderWindow window(gameWindow, "The Great Deku Bot");
 
+	// AI move searched on its own thread, so the window keeps answering while the AI thinks
+	std::future<void> aiMove;
+
 	// Main Loop
 	while (window.isOpen())
 	{
+		// The board belongs to the search until the AI has moved
+		bool thinking = aiMove.valid() && aiMove.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+
 		// Event Manager
 		sf::Event event;
 		if (window.pollEvent(event))
 		{
-			// Close window when red x is pressed
+			// Close window when red x is pressed, stopping the AI if it is still thinking
 			if (event.type == sf::Event::Closed)
+			{
+				deku.Stop();
 				window.close();
+			}
+
+			// Ignore the mouse while the AI thinks
+			if (thinking)
+				continue;
 
 			// Log initial coordinates of mouse press
 			if (event.type == sf::Event::MouseButtonPressed)
@@ -127,15 +143,26 @@ int main(int argc, char* argv[])
 		}
 
 
+		// Keep the last frame while the AI thinks, since the search may change the board at any moment
+		if (thinking)
+		{
+			sf::sleep(sf::milliseconds(10));
+			continue;
+		}
+
 		// Window Refresh
 		window.clear();
 		window.draw(drawable);
 		window.display();
 
-		// Make an AI Move if it is AI's turn
-		if (aiColor == 1 && board.whosTurn() || aiColor == -1 && !board.whosTurn())
-			deku.MakeMove(maxTime);
+		// Make an AI Move if it is AI's turn, until the AI has no move left
+		if (window.isOpen() && !deku.IsGameOver() && (aiColor == 1 && board.whosTurn() || aiColor == -1 && !board.whosTurn()))
+			aiMove = std::async(std::launch::async, [&deku, maxTime]() { deku.MakeMove(maxTime); });
 	}
 
+	// A search that started before its stop could be seen is asked again until it returns
+	while (aiMove.valid() && aiMove.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready)
+		deku.Stop();
+
 	return 0;
 }
\ No newline at end of file
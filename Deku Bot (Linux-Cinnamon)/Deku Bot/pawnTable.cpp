@@ -0,0 +1,7 @@
+#include "PawnTable.hpp"
+
+// Default Constructor; Every entry starts out holding the structure without pawns
+// The key of a board without pawns is zero, so the empty entries are already correct for it
+PawnTable::PawnTable() : entries(new PawnEntry[size]())
+{
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "GameBoard.hpp"
+#include <chrono>
+#include <iostream>
+
+// A position with the number of move sequences known for each depth
+struct ReferencePosition
+{
+	const char* fen;
+	int depth;
+	long long nodes;
+};
+
+// Standard positions used to check move generators
+// Together they cover castling, en passant, promotions, pins and checks
+static const ReferencePosition referencePositions[] = {
+	{ "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324 },
+	{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690 },
+	{ "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083 },
+	{ "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333 },
+	{ "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 4, 422333 },
+	{ "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487 },
+	{ "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 }
+};
+
+// Counts the move sequences of a given depth from a board
+static long long perft(GameBoard& board, const int depth)
+{
+	MoveList moves;
+	board.FindMoves(board.whosTurn() ? 1 : -1, moves);
+
+	// Every generated move is legal, so the last level only needs counting
+	if (depth <= 1)
+		return moves.Size();
+
+	long long nodes = 0;
+	for (auto& move : moves)
+	{
+		UndoRecord undo;
+		board.DoMove(move, undo);
+		nodes += perft(board, depth - 1);
+		board.UndoMove(move, undo);
+	}
+
+	return nodes;
+}
+
+// Counts the move sequences below each move of the board, printing one line per move
+// Returns the total number of sequences
+static long long divide(GameBoard& board, const int depth)
+{
+	MoveList moves;
+	board.FindMoves(board.whosTurn() ? 1 : -1, moves);
+
+	long long nodes = 0;
+	for (auto& move : moves)
+	{
+		UndoRecord undo;
+		board.DoMove(move, undo);
+		long long moveNodes = perft(board, depth - 1);
+		board.UndoMove(move, undo);
+
+		std::cout << move.Notation() << ": " << moveNodes << std::endl;
+		nodes += moveNodes;
+	}
+
+	return nodes;
+}
+
+// Runs a timed count on a position and prints the nodes and nodes per second
+// Returns the number of nodes found
+static long long timedCount(const std::string& fen, const int depth, const bool showMoves)
+{
+	GameBoard board(fen);
+
+	auto start = std::chrono::steady_clock::now();
+	long long nodes = showMoves ? divide(board, depth) : perft(board, depth);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Nodes: " << nodes << " | Time: " << seconds << "s | NPS: " << (long long)(nodes / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+	return nodes;
+}
+
+// Usage: perft [depth] [FEN]
+// With no arguments every reference position is checked against its known count
+int main(int argc, char* argv[])
+{
+	// Count a single position, split by the first move
+	if (argc > 1)
+	{
+		int depth = std::stoi(argv[1]);
+		std::string fen = (argc > 2) ? argv[2] : referencePositions[0].fen;
+
+		// Allow the FEN fields to be passed as separate arguments
+		for (int i = 3; i < argc; i++)
+			fen += std::string(" ") + argv[i];
+
+		if (depth < 1)
+		{
+			std::cout << "Depth must be at least 1" << std::endl;
+			return -1;
+		}
+
+		timedCount(fen, depth, true);
+		return 0;
+	}
+
+	// Check every reference position
+	int failures = 0;
+	for (auto& position : referencePositions)
+	{
+		std::cout << position.fen << " (Depth " << position.depth << ")" << std::endl;
+
+		long long nodes = timedCount(position.fen, position.depth, false);
+		if (nodes != position.nodes)
+		{
+			std::cout << "Failed: Expected " << position.nodes << std::endl;
+			failures++;
+		}
+	}
+
+	std::cout << (failures == 0 ? "All Positions Passed" : "Some Positions Failed") << std::endl;
+	return failures == 0 ? 0 : -1;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "Test.hpp"
+#include <iostream>
+
+// ./tests
+// Runs every test without the window; Built with the allocation counter, unlike the game
+int main()
+{
+	runAllTests();
+	std::cout << "All Tests Passed" << std::endl;
+	return 0;
+}
\ No newline at end of file
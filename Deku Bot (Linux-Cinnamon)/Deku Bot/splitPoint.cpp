@@ -0,0 +1,39 @@
+#include "SplitPoint.hpp"
+
+// Offers a split point to other threads
+void SplitDeque::Push(SplitPoint* split)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	points[size++] = split;
+}
+
+// Takes back the newest split point so no more threads join it
+void SplitDeque::Pop()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	size--;
+}
+
+// Joins the oldest split point that still has moves left; Only those below an ancestor if one is given
+// Returns the split point with its worker count raised, or null if none could be joined
+SplitPoint* SplitDeque::Steal(const SplitPoint* ancestor)
+{
+	// The worker count is raised while the split point can not be taken back, so its owner always waits for the new worker
+	std::lock_guard<std::mutex> guard(lock);
+
+	for (int i = 0; i < size; i++)
+	{
+		SplitPoint* split = points[i];
+
+		if (ancestor && !split->Descends(ancestor))
+			continue;
+
+		if (split->HasWork())
+		{
+			split->workers++;
+			return split;
+		}
+	}
+
+	return nullptr;
+}
\ No newline at end of file
@@ -1,5 +1,44 @@
 #include "Test.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <thread>
+
+// Counts every heap allocation made by the program
+static std::atomic<long long> allocations(0);
+
+// Only the headless test build replaces the allocator; The game keeps the standard one
+#ifdef COUNT_ALLOCATIONS
+
+// Replace the global allocator so every allocation is counted
+void* operator new(std::size_t size)
+{
+	allocations++;
+
+	if (void* memory = std::malloc(size ? size : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
+
+// Returns the number of heap allocations made since the program started
+long long allocationCount()
+{
+	return allocations;
+}
 
 // Run all tests
 void runAllTests()
@@ -7,6 +46,19 @@ void runAllTests()
 	testBoardConstructor();
 	testBoardFitness();
 	testMoveMethod();
+	testUndoMove();
+	testLegalMoves();
+	testTranspositionTable();
+	testMoveOrdering();
+	testQuiescence();
+	testSearchStop();
+	testPrincipalVariation();
+	testSearchNullMove();
+	testSearchAspiration();
+	testSearchReductions();
+	testSearchAllocations();
+	testDrawDetection();
+	testEvaluationCache();
 }
 
 // Test Game Board Constructors
@@ -206,6 +258,30 @@ void testBoardConstructor()
 		std::cout << "Failed Turn Order Flag" << std::endl;
 		exit(-1);
 	}
+
+	// The starting position written in FEN must match the default board
+	GameBoard fenTest("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	for (int x = 0; x < 8; x++)
+		for (int y = 0; y < 8; y++)
+			if (fenTest.gameBoard[x][y] != defaultTest.gameBoard[x][y])
+			{
+				std::cout << "Failed FEN Constructor" << std::endl;
+				exit(-4);
+			}
+
+	if (fenTest.positionKey() != defaultTest.positionKey())
+	{
+		std::cout << "Failed FEN Constructor Key" << std::endl;
+		exit(-4);
+	}
+
+	// Turn, castling rights and en passant are read from their own fields
+	GameBoard fenFlagsTest("4k2r/8/8/8/3pP3/8/8/4K3 b k e3 0 1");
+	if (fenFlagsTest.whosTurn() || fenFlagsTest.gameBoard[4][0] != -9 || fenFlagsTest.gameBoard[7][0] != -4 || fenFlagsTest.gameBoard[4][4] != 2)
+	{
+		std::cout << "Failed FEN Constructor Flags" << std::endl;
+		exit(-4);
+	}
 }
 
 // Test Game Board Fitness Method
@@ -312,12 +388,12 @@ void testBoardFitness()
 	// Rooks
 	customStart[3][3] = 3;
 	GameBoard rookPiece(customStart);
-	if (rookPiece.RankBoard(1) != 17)
+	if (rookPiece.RankBoard(1) != 20)
 	{
 		std::cout << "Failed Rook" << std::endl;
 		exit(-1);
 	}
-	if (rookPiece.RankBoard(-1) != -17)
+	if (rookPiece.RankBoard(-1) != -20)
 	{
 		std::cout << "Failed Rook" << std::endl;
 		exit(-2);
@@ -326,12 +402,12 @@ void testBoardFitness()
 	// Knights
 	customStart[3][3] = 5;
 	GameBoard knightPiece(customStart);
-	if (knightPiece.RankBoard(1) != 13)
+	if (knightPiece.RankBoard(1) != 12)
 	{
 		std::cout << "Failed Knight" << std::endl;
 		exit(-1);
 	}
-	if (knightPiece.RankBoard(-1) != -13)
+	if (knightPiece.RankBoard(-1) != -12)
 	{
 		std::cout << "Failed Knight" << std::endl;
 		exit(-2);
@@ -341,12 +417,12 @@ void testBoardFitness()
 	customStart[3][3] = 0;
 	customStart[4][3] = 6;
 	GameBoard bishopPiece(customStart);
-	if (bishopPiece.RankBoard(1) != 19)
+	if (bishopPiece.RankBoard(1) != 23)
 	{
 		std::cout << "Failed Bishop" << std::endl;
 		exit(-1);
 	}
-	if (bishopPiece.RankBoard(-1) != -19)
+	if (bishopPiece.RankBoard(-1) != -23)
 	{
 		std::cout << "Failed Bishop" << std::endl;
 		exit(-2);
@@ -355,12 +431,12 @@ void testBoardFitness()
 	// Queens
 	customStart[4][3] = 7;
 	GameBoard queenPiece(customStart);
-	if (queenPiece.RankBoard(1) != 34)
+	if (queenPiece.RankBoard(1) != 38)
 	{
 		std::cout << "Failed Queen" << std::endl;
 		exit(-1);
 	}
-	if (queenPiece.RankBoard(-1) != -34)
+	if (queenPiece.RankBoard(-1) != -38)
 	{
 		std::cout << "Failed Queen" << std::endl;
 		exit(-2);
@@ -371,12 +447,12 @@ void testBoardFitness()
 	customStart[4][3] = 0;
 	customStart[0][5] = 3;
 	GameBoard whiteRookCheck(customStart);
-	if (whiteRookCheck.RankBoard(1) != 518)
+	if (whiteRookCheck.RankBoard(1) != 513)
 	{
 		std::cout << "Failed Check White Rook" << std::endl;
 		exit(-1);
 	}
-	if (whiteRookCheck.RankBoard(-1) != -518)
+	if (whiteRookCheck.RankBoard(-1) != -513)
 	{
 		std::cout << "Failed Check White Rook" << std::endl;
 		exit(-2);
@@ -385,12 +461,12 @@ void testBoardFitness()
 	customStart[0][5] = 0;
 	customStart[7][5] = -4;
 	GameBoard blackRookCheck(customStart);
-	if (blackRookCheck.RankBoard(-1) != 518)
+	if (blackRookCheck.RankBoard(-1) != 513)
 	{
 		std::cout << "Failed Check Black Rook" << std::endl;
 		exit(-1);
 	}
-	if (blackRookCheck.RankBoard(1) != -518)
+	if (blackRookCheck.RankBoard(1) != -513)
 	{
 		std::cout << "Failed Check Black Rook" << std::endl;
 		exit(-2);
@@ -400,12 +476,12 @@ void testBoardFitness()
 	customStart[7][5] = 0;
 	customStart[2][1] = 5;
 	GameBoard whiteKnightCheck(customStart);
-	if (whiteKnightCheck.RankBoard(1) != 512)
+	if (whiteKnightCheck.RankBoard(1) != 506)
 	{
 		std::cout << "Failed Check White Knight" << std::endl;
 		exit(-1);
 	}
-	if (whiteKnightCheck.RankBoard(-1) != -512)
+	if (whiteKnightCheck.RankBoard(-1) != -506)
 	{
 		std::cout << "Failed Check White Knight" << std::endl;
 		exit(-2);
@@ -415,12 +491,12 @@ void testBoardFitness()
 	customStart[5][6] = -5;
 
 	GameBoard blackKnightCheck(customStart);
-	if (blackKnightCheck.RankBoard(1) != -512)
+	if (blackKnightCheck.RankBoard(1) != -506)
 	{
 		std::cout << "Failed Check Black Knight" << std::endl;
 		exit(-1);
 	}
-	if (blackKnightCheck.RankBoard(-1) != 512)
+	if (blackKnightCheck.RankBoard(-1) != 506)
 	{
 		std::cout << "Failed Check Black Knight" << std::endl;
 		exit(-2);
@@ -429,12 +505,12 @@ void testBoardFitness()
 	customStart[5][6] = 5;
 
 	GameBoard noCheckKnight(customStart);
-	if (noCheckKnight.RankBoard(1) == -512)
+	if (noCheckKnight.RankBoard(1) == -506)
 	{
 		std::cout << "Failed Check Knight False Flag" << std::endl;
 		exit(-1);
 	}
-	if (noCheckKnight.RankBoard(-1) == 512)
+	if (noCheckKnight.RankBoard(-1) == 506)
 	{
 		std::cout << "Failed Check Knight False Flag" << std::endl;
 		exit(-2);
@@ -443,12 +519,12 @@ void testBoardFitness()
 	customStart[5][6] = 0;
 	customStart[2][1] = -5;
 	GameBoard noCheckKnightTwo(customStart);
-	if (noCheckKnightTwo.RankBoard(-1) == -512)
+	if (noCheckKnightTwo.RankBoard(-1) == -506)
 	{
 		std::cout << "Failed Check Knight False Flag" << std::endl;
 		exit(-3);
 	}
-	if (noCheckKnightTwo.RankBoard(1) == 512)
+	if (noCheckKnightTwo.RankBoard(1) == 506)
 	{
 		std::cout << "Failed Check Knight False Flag" << std::endl;
 		exit(-4);
@@ -486,12 +562,12 @@ void testBoardFitness()
 	// Queen
 	customStart[3][3] = 7;
 	GameBoard whiteQueenCheck(customStart);
-	if (whiteQueenCheck.RankBoard(1) != 536)
+	if (whiteQueenCheck.RankBoard(1) != 523)
 	{
 		std::cout << "Failed Check White Queen" << std::endl;
 		exit(-1);
 	}
-	if (whiteQueenCheck.RankBoard(-1) != -536)
+	if (whiteQueenCheck.RankBoard(-1) != -523)
 	{
 		std::cout << "Failed Check White Queen" << std::endl;
 		exit(-2);
@@ -500,16 +576,61 @@ void testBoardFitness()
 	customStart[3][3] = -7;
 
 	GameBoard blackQueenCheck(customStart);
-	if (blackQueenCheck.RankBoard(1) != -536)
+	if (blackQueenCheck.RankBoard(1) != -523)
 	{
 		std::cout << "Failed Check Black Queen" << std::endl;
 		exit(-1);
 	}
-	if (blackQueenCheck.RankBoard(-1) != 536)
+	if (blackQueenCheck.RankBoard(-1) != 523)
 	{
 		std::cout << "Failed Check Black Queen" << std::endl;
 		exit(-2);
 	}
+
+	// Pawn structures looked up in a table score the same as ones scored from scratch
+	// Boards with the same pawns share a pawn key, so the second board is scored from the first board's entry
+	PawnTable pawnTable;
+	GameBoard pawnTest("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	GameBoard samePawns("4k3/p1pp1p2/4p1p1/3P4/1p2P3/7p/PPP2PPP/4K3 w - - 0 1");
+	if (pawnTest.pawnKey() != samePawns.pawnKey() || pawnTest.pawnKey() == commonTest.pawnKey())
+	{
+		std::cout << "Failed Pawn Key" << std::endl;
+		exit(-1);
+	}
+
+	for (auto board : { &pawnTest, &samePawns, &commonTest })
+		if (board->RankBoard(1, &pawnTable) != board->RankBoard(1) || board->RankBoard(-1, &pawnTable) != board->RankBoard(-1))
+		{
+			std::cout << "Failed Pawn Table" << std::endl;
+			exit(-2);
+		}
+
+	// The phase runs from a full board down to kings and pawns
+	if (commonTest.gamePhase() != 24 || winTest.gamePhase() != 0)
+	{
+		std::cout << "Failed Game Phase" << std::endl;
+		exit(-1);
+	}
+
+	// With every piece on the board a king belongs at home, while with only kings left it belongs in the center
+	GameBoard homeKing("rnbqkbnr/8/8/8/8/8/8/RNBQKBNR w - - 0 1");
+	GameBoard centerKing("rnbqkbnr/8/8/8/4K3/8/8/RNBQ1BNR w - - 0 1");
+	GameBoard loneHomeKing("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+	GameBoard loneCenterKing("4k3/8/8/8/4K3/8/8/8 w - - 0 1");
+	if (homeKing.RankBoard(1) <= centerKing.RankBoard(1) || loneHomeKing.RankBoard(1) >= loneCenterKing.RankBoard(1))
+	{
+		std::cout << "Failed Tapered King" << std::endl;
+		exit(-2);
+	}
+
+	// A queen is worth more, and its reach counts for more, once the board empties; The knights cancel each other out
+	GameBoard crowdedQueen("n3k2n/8/8/2Q5/8/8/8/N3K2N w - - 0 1");
+	GameBoard loneQueen("4k3/8/8/2Q5/8/8/8/4K3 w - - 0 1");
+	if (crowdedQueen.RankBoard(1) >= loneQueen.RankBoard(1) || crowdedQueen.RankBoard(-1) != -crowdedQueen.RankBoard(1))
+	{
+		std::cout << "Failed Tapered Queen" << std::endl;
+		exit(-3);
+	}
 }
 
 // Test Movement Method
@@ -529,4 +650,759 @@ void testMoveMethod()
 		std::cout << "Failed Number Of Moves Check" << std::endl;
 		exit(-2);
 	}
+}
+
+// Makes and takes back every move to a given depth, failing if the board is not restored
+static void undoEveryMove(GameBoard& board, const int depth)
+{
+	if (depth == 0)
+		return;
+
+	MoveList moves, loudMoves;
+	board.FindMoves(board.whosTurn() ? 1 : -1, moves);
+	board.FindMoves(board.whosTurn() ? 1 : -1, loudMoves, true);
+
+	// The loud moves are exactly the captures and promotions among all moves
+	int loud = 0;
+	for (auto& move : moves)
+		if (move.IsCapture() || move.IsPromotion())
+			loud++;
+	if (loudMoves.Size() != loud)
+	{
+		std::cout << "Failed Loud Moves" << std::endl;
+		exit(-9);
+	}
+
+	for (auto& move : moves)
+	{
+		// Copy of the board before the move
+		GameBoard before(board);
+		bool givesCheck = board.GivesCheck(move);
+
+		UndoRecord undo;
+		board.DoMove(move, undo);
+
+		// A check predicted before the move must match the board after it
+		if (givesCheck != (board.whosTurn() ? board.isWhiteInCheck() : board.isBlackInCheck()))
+		{
+			std::cout << "Failed Gives Check" << std::endl;
+			exit(-10);
+		}
+
+		// The fitness kept up to date by the move must match a board built from scratch
+		if (board.RankBoard(1) != GameBoard(board.gameBoard).RankBoard(1))
+		{
+			std::cout << "Failed Do Move Fitness" << std::endl;
+			exit(-6);
+		}
+
+		undoEveryMove(board, depth - 1);
+		board.UndoMove(move, undo);
+
+		for (int x = 0; x < 8; x++)
+			for (int y = 0; y < 8; y++)
+				if (board.gameBoard[x][y] != before.gameBoard[x][y])
+				{
+					std::cout << "Failed Undo Move Board" << std::endl;
+					exit(-1);
+				}
+
+		if (board.whosTurn() != before.whosTurn() || board.numMovesSinceCapture() != before.numMovesSinceCapture())
+		{
+			std::cout << "Failed Undo Move Flags" << std::endl;
+			exit(-2);
+		}
+
+		if (board.numBlackPieces() != before.numBlackPieces() || board.numWhitePieces() != before.numWhitePieces())
+		{
+			std::cout << "Failed Undo Move Pieces" << std::endl;
+			exit(-3);
+		}
+
+		if (board.isBlackInCheck() != before.isBlackInCheck() || board.isWhiteInCheck() != before.isWhiteInCheck())
+		{
+			std::cout << "Failed Undo Move Checks" << std::endl;
+			exit(-4);
+		}
+
+		if (board.positionKey() != before.positionKey())
+		{
+			std::cout << "Failed Undo Move Key" << std::endl;
+			exit(-5);
+		}
+
+		if (board.RankBoard(1) != before.RankBoard(1))
+		{
+			std::cout << "Failed Undo Move Fitness" << std::endl;
+			exit(-7);
+		}
+
+		if (board.pawnKey() != before.pawnKey())
+		{
+			std::cout << "Failed Undo Move Pawn Key" << std::endl;
+			exit(-8);
+		}
+	}
+}
+
+// Test Make / Unmake Methods
+void testUndoMove()
+{
+	// Castling, en passant and promotions are all possible within three moves
+	piece customStart[8][8] = { 0 };
+	customStart[4][0] = -9;
+	customStart[0][0] = -4;
+	customStart[7][0] = -4;
+	customStart[3][1] = -1;
+	customStart[6][6] = -1;
+	customStart[4][7] = 9;
+	customStart[0][7] = 4;
+	customStart[7][7] = 4;
+	customStart[1][1] = 1;
+	customStart[2][3] = 1;
+
+	GameBoard specialTest(customStart);
+	undoEveryMove(specialTest, 3);
+
+	GameBoard commonTest;
+	undoEveryMove(commonTest, 3);
+
+	// Knights moving out and back reach the starting position again, so they must reach its key
+	commonTest.ApplyMove(Move(62, 45));
+	commonTest.ApplyMove(Move(6, 21));
+	commonTest.ApplyMove(Move(45, 62));
+	commonTest.ApplyMove(Move(21, 6));
+	if (commonTest.positionKey() != GameBoard().positionKey())
+	{
+		std::cout << "Failed Repeated Position Key" << std::endl;
+		exit(-6);
+	}
+
+	// Passing the turn expires en passant and changes the key; Taking the pass back restores both
+	GameBoard nullTest("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+	GameBoard beforeNull(nullTest);
+
+	UndoRecord undo;
+	nullTest.DoNullMove(undo);
+	if (nullTest.whosTurn() || nullTest.gameBoard[3][3] != -1 || nullTest.positionKey() == beforeNull.positionKey())
+	{
+		std::cout << "Failed Null Move" << std::endl;
+		exit(-7);
+	}
+
+	nullTest.UndoNullMove(undo);
+	if (!nullTest.whosTurn() || nullTest.gameBoard[3][3] != -2 || nullTest.positionKey() != beforeNull.positionKey())
+	{
+		std::cout << "Failed Undo Null Move" << std::endl;
+		exit(-8);
+	}
+}
+
+// Counts the move sequences of a given depth from a board
+static long long countMoves(GameBoard& board, const int depth)
+{
+	MoveList moves;
+	board.FindMoves(board.whosTurn() ? 1 : -1, moves);
+
+	if (depth == 1)
+		return moves.Size();
+
+	long long total = 0;
+	for (auto& move : moves)
+	{
+		UndoRecord undo;
+		board.DoMove(move, undo);
+		total += countMoves(board, depth - 1);
+		board.UndoMove(move, undo);
+	}
+
+	return total;
+}
+
+// Test that only legal moves are generated and that the search sees the end of the game
+void testLegalMoves()
+{
+	// Pins, discovered checks and an en passant capture that would expose the king along its row
+	piece pinStart[8][8] = { 0 };
+	pinStart[0][3] = 8;
+	pinStart[1][3] = 1;
+	pinStart[1][4] = 3;
+	pinStart[4][6] = 1;
+	pinStart[6][6] = 1;
+	pinStart[2][1] = -1;
+	pinStart[3][2] = -1;
+	pinStart[7][3] = -3;
+	pinStart[5][4] = -1;
+	pinStart[7][4] = -8;
+
+	// Known number of legal move sequences three moves deep
+	GameBoard pinTest(pinStart);
+	if (countMoves(pinTest, 3) != 2812)
+	{
+		std::cout << "Failed Legal Move Count" << std::endl;
+		exit(-1);
+	}
+
+	// White king in the corner, checked by a queen its own king protects
+	piece mateStart[8][8] = { 0 };
+	mateStart[0][7] = 8;
+	mateStart[1][6] = -7;
+	mateStart[2][5] = -8;
+
+	GameBoard mateTest(mateStart);
+	MoveList moves;
+	mateTest.FindMoves(1, moves);
+	if (moves.Size() != 0 || !mateTest.isWhiteInCheck())
+	{
+		std::cout << "Failed Checkmate Check" << std::endl;
+		exit(-2);
+	}
+
+	// White king in the corner, not in check but with every tile around it attacked
+	piece staleStart[8][8] = { 0 };
+	staleStart[0][7] = 8;
+	staleStart[1][5] = -7;
+	staleStart[7][0] = -8;
+
+	GameBoard staleTest(staleStart);
+	staleTest.FindMoves(1, moves);
+	if (moves.Size() != 0 || staleTest.isWhiteInCheck())
+	{
+		std::cout << "Failed Stalemate Check" << std::endl;
+		exit(-3);
+	}
+
+	// The bot ends the game instead of moving when it has no move left
+	BotTest staleDeku(&staleTest, 1);
+	if (staleDeku.IsGameOver())
+	{
+		std::cout << "Failed Game Over Start" << std::endl;
+		exit(-6);
+	}
+	staleDeku.MakeMove(1);
+	staleDeku.MakeMove(1);
+	if (!staleDeku.IsGameOver() || staleTest.positionKey() != GameBoard(staleStart).positionKey())
+	{
+		std::cout << "Failed Game Over" << std::endl;
+		exit(-7);
+	}
+
+	// White can mate the black king in one move
+	piece searchStart[8][8] = { 0 };
+	searchStart[0][0] = -8;
+	searchStart[1][2] = 8;
+	searchStart[7][1] = 7;
+
+	// The search stops at a fixed depth well before its time runs out, so the result never depends on the speed of the machine
+	GameBoard searchTest(searchStart);
+	BotTest deku(&searchTest, 1);
+	deku.SetDepthLimit(3);
+	Move bestMove = deku.Search(60000);
+
+	UndoRecord undo;
+	searchTest.DoMove(bestMove, undo);
+
+	searchTest.FindMoves(-1, moves);
+	if (moves.Size() != 0 || !searchTest.isBlackInCheck())
+	{
+		std::cout << "Failed Search Checkmate" << std::endl;
+		exit(-4);
+	}
+
+	// Threads sharing nodes must agree on the mate
+	searchTest.UndoMove(bestMove, undo);
+	deku.SetParallelSearch(SplitPoints);
+	deku.SetThreads(4);
+	bestMove = deku.Search(60000);
+
+	searchTest.DoMove(bestMove, undo);
+	searchTest.FindMoves(-1, moves);
+	if (moves.Size() != 0 || !searchTest.isBlackInCheck())
+	{
+		std::cout << "Failed Split Search Checkmate" << std::endl;
+		exit(-5);
+	}
+}
+
+// Test Transposition Table Store / Probe Methods
+void testTranspositionTable()
+{
+	TranspositionTable table(1);
+	GameBoard board;
+	std::uint64_t key = board.positionKey();
+	TableEntry entry;
+
+	// Nothing is found in an empty table
+	if (table.Probe(key, entry))
+	{
+		std::cout << "Failed Empty Table Probe" << std::endl;
+		exit(-1);
+	}
+
+	// A stored position comes back exactly as it went in
+	table.Store(key, Move(52, 36, Move::DoublePush), -42, 5, LowerBound);
+	if (!table.Probe(key, entry) || entry.bestMove != Move(52, 36, Move::DoublePush) || entry.score != -42 || entry.depth != 5 || entry.bound != LowerBound)
+	{
+		std::cout << "Failed Table Store" << std::endl;
+		exit(-2);
+	}
+
+	// A different key in the same bucket must not match
+	if (table.Probe(key ^ (1ULL << 63), entry))
+	{
+		std::cout << "Failed Table Key Check" << std::endl;
+		exit(-3);
+	}
+
+	// Storing the position again without a best move keeps the old one
+	table.Store(key, Move(), 7, 6, UpperBound);
+	if (!table.Probe(key, entry) || entry.bestMove != Move(52, 36, Move::DoublePush) || entry.score != 7 || entry.bound != UpperBound)
+	{
+		std::cout << "Failed Table Move Kept" << std::endl;
+		exit(-4);
+	}
+
+	// A shallower bound from the same search does not replace a deeper result, while an exact score does
+	table.Store(key, Move(), 3, 2, LowerBound);
+	if (!table.Probe(key, entry) || entry.score != 7 || entry.depth != 6)
+	{
+		std::cout << "Failed Table Depth Kept" << std::endl;
+		exit(-7);
+	}
+
+	table.Store(key, Move(), 3, 2, ExactBound);
+	if (!table.Probe(key, entry) || entry.score != 3 || entry.depth != 2 || entry.bound != ExactBound)
+	{
+		std::cout << "Failed Table Exact Replacement" << std::endl;
+		exit(-8);
+	}
+
+	// Filling the bucket during a new search replaces the old entry first, even though it was searched deeper
+	table.NewSearch();
+	for (std::uint64_t i = 1; i <= 4; i++)
+		table.Store(key ^ (i << 60), Move(), 0, 1, ExactBound);
+
+	if (table.Probe(key, entry))
+	{
+		std::cout << "Failed Table Replacement" << std::endl;
+		exit(-5);
+	}
+
+	// Clearing drops every entry
+	table.Clear();
+	if (table.Probe(key ^ (1ULL << 60), entry))
+	{
+		std::cout << "Failed Table Clear" << std::endl;
+		exit(-6);
+	}
+}
+
+// Test Move Ordering Methods
+void testMoveOrdering()
+{
+	// White may take the black queen with a pawn or with its own queen
+	GameBoard board("4k3/8/8/3q4/4P3/8/8/3QK3 w - - 0 1");
+	BotTest deku(&board, 1);
+
+	MoveList moves;
+	board.FindMoves(1, moves);
+	deku.OrderMoves(board, moves, Move(60, 61));
+
+	// The hash move comes first, even though it is quiet
+	if (moves[0] != Move(60, 61))
+	{
+		std::cout << "Failed Hash Move Order" << std::endl;
+		exit(-1);
+	}
+
+	// Taking the queen with the pawn risks less than taking it with the queen
+	if (moves[1] != Move(36, 27, Move::Capture) || moves[2] != Move(59, 27, Move::Capture))
+	{
+		std::cout << "Failed Capture Order" << std::endl;
+		exit(-2);
+	}
+
+	// Quiet moves come after every capture
+	for (int i = 3; i < moves.Size(); i++)
+		if (moves[i].IsCapture())
+		{
+			std::cout << "Failed Quiet Move Order" << std::endl;
+			exit(-3);
+		}
+}
+
+// Test Quiescence Search
+void testQuiescence()
+{
+	// White's rook can take a queen nothing defends, so the board is worth more than it looks
+	GameBoard freeQueen("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+	BotTest freeTest(&freeQueen, 1);
+	if (freeTest.Quiescence(freeQueen) <= freeQueen.RankBoard(1))
+	{
+		std::cout << "Failed Quiescence Free Capture" << std::endl;
+		exit(-1);
+	}
+
+	// White's queen can take a pawn, but loses itself to the pawn behind it, so standing pat is best
+	GameBoard guardedPawn("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1");
+	BotTest guardedTest(&guardedPawn, 1);
+	if (guardedTest.Quiescence(guardedPawn) != guardedPawn.RankBoard(1))
+	{
+		std::cout << "Failed Quiescence Stand Pat" << std::endl;
+		exit(-2);
+	}
+
+	// Searching the captures must leave the board as it was
+	if (guardedPawn.positionKey() != GameBoard("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1").positionKey())
+	{
+		std::cout << "Failed Quiescence Board Restore" << std::endl;
+		exit(-3);
+	}
+}
+
+// Test that the search stops on time without reading the clock every node
+void testSearchStop()
+{
+	GameBoard board;
+	BotTest deku(&board, 1);
+
+	// Polling the clock between nodes may overshoot a little, but never by much
+	auto start = std::chrono::steady_clock::now();
+	Move bestMove = deku.Search(200);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	if (elapsed > 1000)
+	{
+		std::cout << "Failed Search Stop Time" << std::endl;
+		exit(-1);
+	}
+
+	if (bestMove.IsNull())
+	{
+		std::cout << "Failed Search Stop Move" << std::endl;
+		exit(-2);
+	}
+	// A search with no time at all must still answer with a legal move
+	bestMove = deku.Search(0);
+
+	MoveList moves;
+	board.FindMoves(1, moves);
+
+	bool legal = false;
+	for (auto& move : moves)
+		if (move == bestMove)
+			legal = true;
+
+	if (!legal)
+	{
+		std::cout << "Failed Search Stop Fallback" << std::endl;
+		exit(-3);
+	}
+
+	// Helper threads must stop with the main thread, which still answers with a legal move
+	deku.SetThreads(4);
+	start = std::chrono::steady_clock::now();
+	bestMove = deku.Search(200);
+	elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	legal = false;
+	for (auto& move : moves)
+		if (move == bestMove)
+			legal = true;
+
+	if (elapsed > 1000 || !legal)
+	{
+		std::cout << "Failed Search Stop Threads" << std::endl;
+		exit(-4);
+	}
+
+	// Threads sharing nodes through split points must stop just as quickly
+	deku.SetParallelSearch(SplitPoints);
+	start = std::chrono::steady_clock::now();
+	bestMove = deku.Search(200);
+	elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	legal = false;
+	for (auto& move : moves)
+		if (move == bestMove)
+			legal = true;
+
+	if (elapsed > 1000 || !legal)
+	{
+		std::cout << "Failed Search Stop Split Points" << std::endl;
+		exit(-5);
+	}
+	deku.SetParallelSearch(LazySMP);
+
+	// A search stopped from another thread returns quickly with a legal move, however much time it had left
+	for (int threads : { 1, 4 })
+	{
+		deku.SetThreads(threads);
+		std::thread stopper([&deku]()
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			deku.Stop();
+		});
+
+		start = std::chrono::steady_clock::now();
+		bestMove = deku.Search(60000);
+		elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		stopper.join();
+
+		legal = false;
+		for (auto& move : moves)
+			if (move == bestMove)
+				legal = true;
+
+		if (elapsed > 2000 || !legal)
+		{
+			std::cout << "Failed Search Stop Call" << std::endl;
+			exit(-7);
+		}
+	}
+	deku.SetThreads(1);
+
+	// A proven mate ends the search long before its time runs out, without any depth limit
+	piece mateStart[8][8] = { 0 };
+	mateStart[0][0] = -8;
+	mateStart[1][2] = 8;
+	mateStart[7][1] = 7;
+
+	GameBoard mateBoard(mateStart);
+	BotTest mateDeku(&mateBoard, 1);
+	start = std::chrono::steady_clock::now();
+	mateDeku.Search(60000);
+	elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	if (elapsed > 10000)
+	{
+		std::cout << "Failed Search Stop Mate" << std::endl;
+		exit(-6);
+	}
+}
+
+// Test the principal variation kept by the search
+void testPrincipalVariation()
+{
+	GameBoard board;
+	BotTest deku(&board, 1);
+	Move bestMove = deku.Search(100);
+	MoveList line = deku.PrincipalVariation();
+
+	// The line starts with the move the search chose
+	if (line.Size() == 0 || line[0] != bestMove)
+	{
+		std::cout << "Failed Principal Variation Start" << std::endl;
+		exit(-1);
+	}
+
+	// Every move of the line must be legal when its turn comes
+	for (auto& move : line)
+	{
+		MoveList moves;
+		board.FindMoves(board.whosTurn() ? 1 : -1, moves);
+
+		bool legal = false;
+		for (auto& legalMove : moves)
+			if (legalMove == move)
+				legal = true;
+
+		if (!legal)
+		{
+			std::cout << "Failed Principal Variation Legality" << std::endl;
+			exit(-2);
+		}
+
+		board.ApplyMove(move);
+	}
+}
+
+// Test that null moves are only tried where passing can not be the best move
+void testSearchNullMove()
+{
+	// Kings and blocked pawns only; Having to move gives way to the other king, so passing would be the best move
+	GameBoard zugzwang(std::string("8/8/3k4/3p4/3P4/3K4/8/8 w - - 0 1"));
+	BotTest deku(&zugzwang, 1);
+
+	if (deku.NullMoveAllowed(zugzwang, 3, zugzwang.RankBoard(1)))
+	{
+		std::cout << "Failed Null Move Zugzwang" << std::endl;
+		exit(-1);
+	}
+
+	// A knight gives the player spare moves, so passing is safe again
+	GameBoard knight(std::string("8/8/3k4/3p4/3P4/3K4/8/6N1 w - - 0 1"));
+	if (!deku.NullMoveAllowed(knight, 3, knight.RankBoard(1)))
+	{
+		std::cout << "Failed Null Move Pieces" << std::endl;
+		exit(-2);
+	}
+
+	// Too shallow to pass
+	if (deku.NullMoveAllowed(knight, 2, knight.RankBoard(1)))
+	{
+		std::cout << "Failed Null Move Depth" << std::endl;
+		exit(-3);
+	}
+}
+
+// Test that a window too narrow for the score is widened until the search agrees with a full window
+void testSearchAspiration()
+{
+	const char* positions[] = {
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+	};
+
+	for (auto position : positions)
+	{
+		GameBoard fullBoard((std::string(position))), narrowBoard((std::string(position)));
+		BotTest full(&fullBoard, 1), narrow(&narrowBoard, 1);
+
+		// Every depth fails high or low at least once with a window a single point wide
+		full.SetAspirationWindow(100000);
+		narrow.SetAspirationWindow(1);
+		full.SetDepthLimit(5);
+		narrow.SetDepthLimit(5);
+
+		Move fullMove = full.Search(60000);
+		Move narrowMove = narrow.Search(60000);
+
+		if (fullMove != narrowMove || full.Score() != narrow.Score())
+		{
+			std::cout << "Failed Aspiration Window" << std::endl;
+			exit(-1);
+		}
+	}
+}
+
+// Test that reduced moves searched again at full depth leave the best move as an unreduced search finds it
+void testSearchReductions()
+{
+	// Late quiet moves are reduced here, and at least one has to be searched again at full depth
+	std::string position = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+	GameBoard reducedBoard(position), fullBoard(position);
+	BotTest reduced(&reducedBoard, 1), full(&fullBoard, 1);
+
+	full.SetLateMoveReductions(false);
+	reduced.SetDepthLimit(5);
+	full.SetDepthLimit(5);
+
+	Move reducedMove = reduced.Search(60000);
+	Move fullMove = full.Search(60000);
+
+	if (reducedMove != fullMove || reduced.Score() != full.Score())
+	{
+		std::cout << "Failed Late Move Reductions" << std::endl;
+		exit(-1);
+	}
+}
+
+// Test that searching never allocates memory
+void testSearchAllocations()
+{
+	GameBoard board;
+	BotTest deku(&board, 1);
+
+	// Search briefly and count the allocations made
+	long long before = allocationCount();
+	Move bestMove = deku.Search(100);
+
+	if (allocationCount() != before)
+	{
+		std::cout << "Failed Search Allocation Test" << std::endl;
+		exit(-1);
+	}
+
+	// Make sure the search actually found a move
+	if (bestMove.IsNull())
+	{
+		std::cout << "Failed Search Allocation Test" << std::endl;
+		exit(-2);
+	}
+
+	// Threads are started for each search, and starting one allocates its state, as does the list holding them
+	// Beyond that, neither way of sharing the work may allocate
+	const int threads = 4;
+	deku.SetThreads(threads);
+	for (auto mode : { LazySMP, SplitPoints })
+	{
+		deku.SetParallelSearch(mode);
+		before = allocationCount();
+		bestMove = deku.Search(100);
+
+		if (allocationCount() - before > threads || bestMove.IsNull())
+		{
+			std::cout << "Failed Threaded Search Allocation Test" << std::endl;
+			exit(-3);
+		}
+	}
+	deku.SetThreads(1);
+}
+
+// Test that the search scores repetitions and the fifty move rule as draws
+void testDrawDetection()
+{
+	// Only a pawn move keeps the win from being drawn by the fifty move rule
+	GameBoard fiftyMoves("7k/8/8/8/8/8/P7/KQ6 w - - 99 80");
+	BotTest fiftyDeku(&fiftyMoves, 1);
+	Move bestMove = fiftyDeku.Search(100);
+
+	if (bestMove != Move(48, 40) && bestMove != Move(48, 32, Move::DoublePush))
+	{
+		std::cout << "Failed Fifty Move Draw" << std::endl;
+		exit(-1);
+	}
+
+	// A queen down, the AI should take the draw from a position already played twice
+	GameBoard board("k7/8/8/8/8/q7/8/7K w - - 10 40");
+	BotTest deku(&board, 1);
+
+	Move repeatMove(63, 55);
+	GameBoard repeated = board;
+	repeated.ApplyMove(repeatMove);
+	deku.RecordGamePosition(repeated);
+	deku.RecordGamePosition(board);
+	deku.RecordGamePosition(repeated);
+
+	bestMove = deku.Search(100);
+	if (bestMove != repeatMove)
+	{
+		std::cout << "Failed Repetition Draw" << std::endl;
+		exit(-2);
+	}
+}
+
+// Test that cached evaluations match the board's own ranking
+void testEvaluationCache()
+{
+	GameBoard board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	BotTest deku(&board, -1);
+
+	// Score every position after each move, once to fill the cache and again to read it back
+	MoveList moves;
+	board.FindMoves(1, moves);
+	for (int pass = 0; pass < 2; pass++)
+		for (auto& move : moves)
+		{
+			UndoRecord undo;
+			board.DoMove(move, undo);
+
+			if (deku.Evaluate(board) != board.RankBoard(-1))
+			{
+				std::cout << "Failed Evaluation Cache" << std::endl;
+				exit(-1);
+			}
+
+			board.UndoMove(move, undo);
+		}
+
+	// A board drawn by the fifty move rule shares its key with the same board a move earlier, so it must skip the cache
+	GameBoard fiftyBefore("7k/8/8/8/8/8/8/KQ6 w - - 98 80");
+	GameBoard fiftyAfter("7k/8/8/8/8/8/8/KQ6 w - - 100 80");
+	if (deku.Evaluate(fiftyBefore) != fiftyBefore.RankBoard(-1) || deku.Evaluate(fiftyAfter) != fiftyAfter.RankBoard(-1))
+	{
+		std::cout << "Failed Evaluation Cache Fifty Moves" << std::endl;
+		exit(-2);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "TranspositionTable.hpp"
+
+// Layout of the packed data of a slot
+// Bits 0-15 -> Move | Bits 16-31 -> Score | Bits 32-39 -> Depth | Bits 40-41 -> Bound | Bits 48-55 -> Generation
+static std::uint64_t pack(const Move move, const int score, const int depth, const Bound bound, const std::uint8_t generation)
+{
+	return (std::uint64_t)move.data
+		| ((std::uint64_t)(std::uint16_t)score << 16)
+		| ((std::uint64_t)(depth < 255 ? depth : 255) << 32)
+		| ((std::uint64_t)bound << 40)
+		| ((std::uint64_t)generation << 48);
+}
+
+static int depthOf(const std::uint64_t data)
+{ return (data >> 32) & 255; }
+
+static Bound boundOf(const std::uint64_t data)
+{ return (Bound)((data >> 40) & 3); }
+
+static std::uint8_t generationOf(const std::uint64_t data)
+{ return (data >> 48) & 255; }
+
+// Explicit Constructor takes the size of the table in megabytes
+TranspositionTable::TranspositionTable(const int megabytes)
+{
+	generation = 0;
+	Resize(megabytes);
+}
+
+// Reallocates the table to a given size in megabytes, dropping every entry
+void TranspositionTable::Resize(const int megabytes)
+{
+	// Largest power of two number of buckets that fits, with at least one bucket
+	std::uint64_t count = 1;
+	while (count * 2 * sizeof(Bucket) <= (std::uint64_t)(megabytes > 0 ? megabytes : 1) << 20)
+		count *= 2;
+
+	buckets.reset(new Bucket[count]);
+	bucketMask = count - 1;
+	Clear();
+}
+
+// Drops every entry
+void TranspositionTable::Clear()
+{
+	for (std::uint64_t i = 0; i <= bucketMask; i++)
+		for (int slot = 0; slot < Bucket::slots; slot++)
+		{
+			buckets[i].keys[slot].store(0, std::memory_order_relaxed);
+			buckets[i].data[slot].store(0, std::memory_order_relaxed);
+		}
+}
+
+// Looks up a position by its key
+// Returns true and fills the entry if the position was found
+bool TranspositionTable::Probe(const std::uint64_t key, TableEntry& entry) const
+{
+	const Bucket& bucket = buckets[key & bucketMask];
+
+	for (int slot = 0; slot < Bucket::slots; slot++)
+	{
+		std::uint64_t data = bucket.data[slot].load(std::memory_order_relaxed);
+
+		// The key only comes back out if the data read belongs to it
+		if ((bucket.keys[slot].load(std::memory_order_relaxed) ^ data) != key || boundOf(data) == NoBound)
+			continue;
+
+		entry.bestMove.data = (std::uint16_t)data;
+		entry.score = (std::int16_t)(data >> 16);
+		entry.depth = depthOf(data);
+		entry.bound = boundOf(data);
+		return true;
+	}
+
+	return false;
+}
+
+// Stores the result of searching a position
+void TranspositionTable::Store(const std::uint64_t key, const Move bestMove, const int score, const int depth, const Bound bound)
+{
+	Bucket& bucket = buckets[key & bucketMask];
+
+	// Replace the same position if it is already stored, otherwise the slot worth the least
+	// Old searches are worth less than any depth of the current search
+	Move move = bestMove;
+	int replace = 0, lowestWorth = INT32_MAX;
+	for (int slot = 0; slot < Bucket::slots; slot++)
+	{
+		std::uint64_t data = bucket.data[slot].load(std::memory_order_relaxed);
+
+		if ((bucket.keys[slot].load(std::memory_order_relaxed) ^ data) == key)
+		{
+			// A shallower bound from the same search knows less than what is stored, so the deeper result stays
+			if (depth < depthOf(data) && bound != ExactBound && generationOf(data) == generation && boundOf(data) != NoBound)
+				return;
+
+			// Keep the old best move when the new search did not find one
+			if (move.IsNull())
+				move.data = (std::uint16_t)data;
+
+			replace = slot;
+			break;
+		}
+
+		int worth = (boundOf(data) == NoBound) ? INT32_MIN : depthOf(data) - 256 * (std::uint8_t)(generation - generationOf(data));
+		if (worth < lowestWorth)
+		{
+			lowestWorth = worth;
+			replace = slot;
+		}
+	}
+
+	std::uint64_t packed = pack(move, score, depth, bound, generation);
+	bucket.data[replace].store(packed, std::memory_order_relaxed);
+	bucket.keys[replace].store(key ^ packed, std::memory_order_relaxed);
+}
\ No newline at end of file